@@ -17,6 +17,7 @@
 #include "utl/io.h"
 #include <algorithm>
 #include <format>
+#include <thread>
 
 namespace vamiga {
 
@@ -79,7 +80,9 @@ Amiga::Amiga(class Emulator& ref, isize id) : CoreComponent(ref, id)
         &remoteManager,
         &retroShell,
         &osDebugger,
-        &regressionTester
+        &regressionTester,
+        &streamExporter,
+        &recorder
     };
 
     info.bind([this] { return cacheInfo(); } );
@@ -179,9 +182,16 @@ Amiga::getOption(Opt option) const
         case Opt::AMIGA_WARP_BOOT:       return (i64)config.warpBoot;
         case Opt::AMIGA_WARP_MODE:       return (i64)config.warpMode;
         case Opt::AMIGA_VSYNC:           return (i64)config.vsync;
+        case Opt::AMIGA_PACING:          return (i64)config.pacing;
+        case Opt::AMIGA_SPIN_TIME:       return (i64)config.spinTime;
+        case Opt::AMIGA_CPU_CORE:        return (i64)config.cpuCore;
+        case Opt::AMIGA_RT_PRIORITY:     return (i64)config.rtPriority;
         case Opt::AMIGA_SPEED_BOOST:     return (i64)config.speedBoost;
         case Opt::AMIGA_RUN_AHEAD:       return (i64)config.runAhead;
+        case Opt::AMIGA_SPECULATION:     return (i64)config.speculation;
         case Opt::AMIGA_WS_COMPRESSION:  return (i64)config.compressWorkspaces;
+        case Opt::AMIGA_SNAP_MEDIA_STORE: return (i64)config.snapshotMediaStore;
+        case Opt::AMIGA_BOOT_CACHE:      return (i64)config.bootCache;
 
         default:
             fatalError;
@@ -214,6 +224,32 @@ Amiga::checkOption(Opt opt, i64 value)
         case Opt::AMIGA_VSYNC:
             
             return;
+
+        case Opt::AMIGA_PACING:
+
+            if (!PacingEnum::isValid(value)) {
+                throw CoreError(CoreError::OPT_INV_ARG, PacingEnum::keyList());
+            }
+            return;
+
+        case Opt::AMIGA_SPIN_TIME:
+
+            if (value < 0 || value > 10000) {
+                throw CoreError(CoreError::OPT_INV_ARG, "0...10000");
+            }
+            return;
+
+        case Opt::AMIGA_CPU_CORE:
+
+            if (value < -1 || value >= std::max(1U, std::thread::hardware_concurrency())) {
+                throw CoreError(CoreError::OPT_INV_ARG,
+                                "-1..." + std::to_string(std::max(1U, std::thread::hardware_concurrency()) - 1));
+            }
+            return;
+
+        case Opt::AMIGA_RT_PRIORITY:
+
+            return;
             
         case Opt::AMIGA_SPEED_BOOST:
             
@@ -229,7 +265,16 @@ Amiga::checkOption(Opt opt, i64 value)
             }
             return;
 
+        case Opt::AMIGA_SPECULATION:
+
+            if (value < 0 || value > 4) {
+                throw CoreError(CoreError::OPT_INV_ARG, "0...4");
+            }
+            return;
+
         case Opt::AMIGA_WS_COMPRESSION:
+        case Opt::AMIGA_SNAP_MEDIA_STORE:
+        case Opt::AMIGA_BOOT_CACHE:
 
             return;
             
@@ -266,6 +311,26 @@ Amiga::setOption(Opt option, i64 value)
             
             config.vsync = bool(value);
             return;
+
+        case Opt::AMIGA_PACING:
+
+            config.pacing = Pacing(value);
+            return;
+
+        case Opt::AMIGA_SPIN_TIME:
+
+            config.spinTime = isize(value);
+            return;
+
+        case Opt::AMIGA_CPU_CORE:
+
+            config.cpuCore = isize(value);
+            return;
+
+        case Opt::AMIGA_RT_PRIORITY:
+
+            config.rtPriority = bool(value);
+            return;
             
         case Opt::AMIGA_SPEED_BOOST:
             
@@ -277,11 +342,26 @@ Amiga::setOption(Opt option, i64 value)
             config.runAhead = isize(value);
             return;
 
+        case Opt::AMIGA_SPECULATION:
+
+            config.speculation = isize(value);
+            return;
+
         case Opt::AMIGA_WS_COMPRESSION:
             
             config.compressWorkspaces = bool(value);
             return;
 
+        case Opt::AMIGA_SNAP_MEDIA_STORE:
+
+            config.snapshotMediaStore = bool(value);
+            return;
+
+        case Opt::AMIGA_BOOT_CACHE:
+
+            config.bootCache = bool(value);
+            return;
+
         default:
             fatalError;
     }
@@ -801,6 +881,10 @@ Amiga::_powerOn()
     loginfo(RUN_DEBUG, "_powerOn\n");
 
     hardReset();
+
+    // Fast-forward to a cached boot state if possible
+    if (config.bootCache && objid == 0) restoreBootState();
+
     msgQueue.put(Msg::POWER, 1);
 }
 
@@ -939,24 +1023,13 @@ Amiga::update(CmdQueue &queue)
             case Cmd::KEY_TOGGLE:
             case Cmd::KEY_LOCK:
             case Cmd::KEY_UNLOCK:
-
-                keyboard.processCommand(cmd);
-                break;
-
             case Cmd::MOUSE_MOVE_ABS:
             case Cmd::MOUSE_MOVE_REL:
-            {
-                auto &port = cmd.coord.port ? controlPort2 : controlPort1;
-                port.processCommand(cmd); break;
-                break;
-            }
             case Cmd::MOUSE_BUTTON:
             case Cmd::JOY_EVENT:
-            {
-                auto &port = cmd.action.port ? controlPort2 : controlPort1;
-                port.processCommand(cmd); break;
+
+                processInput(cmd);
                 break;
-            }
             case Cmd::DSK_TOGGLE_WP:
             case Cmd::DSK_MODIFIED:
             case Cmd::DSK_UNMODIFIED:
@@ -970,6 +1043,11 @@ Amiga::update(CmdQueue &queue)
                 retroShell.exec();
                 break;
 
+            case Cmd::RPC_EXECUTE:
+
+                remoteManager.rpcServer.exec();
+                break;
+
             case Cmd::FOCUS:
 
                 cmd.value ? focus() : unfocus();
@@ -990,6 +1068,56 @@ Amiga::update(CmdQueue &queue)
     remoteManager.update();
 }
 
+bool
+Amiga::isInput(const Command &cmd)
+{
+    switch (cmd.type) {
+
+        case Cmd::KEY_PRESS:
+        case Cmd::KEY_RELEASE:
+        case Cmd::KEY_RELEASE_ALL:
+        case Cmd::KEY_TOGGLE:
+        case Cmd::KEY_LOCK:
+        case Cmd::KEY_UNLOCK:
+        case Cmd::MOUSE_MOVE_ABS:
+        case Cmd::MOUSE_MOVE_REL:
+        case Cmd::MOUSE_BUTTON:
+        case Cmd::JOY_EVENT:
+
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+void
+Amiga::processInput(const Command &cmd)
+{
+    switch (cmd.type) {
+
+        case Cmd::MOUSE_MOVE_ABS:
+        case Cmd::MOUSE_MOVE_REL:
+        {
+            auto &port = cmd.coord.port ? controlPort2 : controlPort1;
+            port.processCommand(cmd);
+            break;
+        }
+        case Cmd::MOUSE_BUTTON:
+        case Cmd::JOY_EVENT:
+        {
+            auto &port = cmd.action.port ? controlPort2 : controlPort1;
+            port.processCommand(cmd);
+            break;
+        }
+
+        default:
+
+            assert(isInput(cmd));
+            keyboard.processCommand(cmd);
+    }
+}
+
 void
 Amiga::computeFrame()
 {
@@ -1084,6 +1212,12 @@ Amiga::computeFrame()
                 action = pause;
             }
 
+            // Did we reach the point where boot states are recorded?
+            if (flags & RL::BOOT_STATE) {
+
+                saveBootState();
+            }
+
             // Are we requested to pause the emulator?
             if (flags & RL::STOP) {
 
@@ -1134,17 +1268,29 @@ Amiga::cacheInfo() const
 void
 Amiga::setFlag(u32 flag)
 {
-    assert(isEmulatorThread());
+    assert(isEmulatorThread() || isRunAheadInstance());
     flags |= flag;
 }
 
 void
 Amiga::clearFlag(u32 flag)
 {
-    assert(isEmulatorThread());
+    assert(isEmulatorThread() || isRunAheadInstance());
     flags &= ~flag;
 }
 
+MediaStore &
+Amiga::getMediaStore()
+{
+    auto path = host.getMediaPath();
+
+    // Reopen the store if the location has changed
+    if (!mediaStore || mediaStore->getRoot() != path) {
+        mediaStore = make_unique<MediaStore>(path);
+    }
+    return *mediaStore;
+}
+
 unique_ptr<Snapshot>
 Amiga::takeSnapshot(Compressor compressor, isize delay, bool repeat)
 {
@@ -1156,7 +1302,8 @@ Amiga::takeSnapshot(Compressor compressor, isize delay, bool repeat)
     }
 
     // Take the snapshot
-    auto result = make_unique<Snapshot>(*this);
+    auto store = config.snapshotMediaStore ? &getMediaStore() : nullptr;
+    auto result = make_unique<Snapshot>(*this, store);
 
     // Compress the snapshot if requested
     result->compress(compressor);
@@ -1207,17 +1354,107 @@ Amiga::loadSnapshot(const Snapshot &snapshot)
     snap.uncompress();
     
     // Restore the saved state (may throw)
-    load(snap.getData() + sizeof(SnapshotHeader));
+    auto store = snap.referencesMedia() ? &getMediaStore() : nullptr;
+    load(snap.getData() + sizeof(SnapshotHeader), store);
     
     // Inform the GUI
     msgQueue.put(Msg::SNAPSHOT_RESTORED);
     msgQueue.put(Msg::VIDEO_FORMAT, agnus.isPAL() ? (i64)TV::PAL : (i64)TV::NTSC);
 }
 
+void
+Amiga::restoreBootState()
+{
+    pendingBootState = 0;
+
+    try {
+
+        auto key = bootStateKey();
+        auto path = bootStatePath(key);
+
+        if (!fs::exists(path)) {
+
+            // Record the boot state when DF0 is accessed for the first time
+            pendingBootState = key;
+            return;
+        }
+
+        Snapshot snap(path);
+        snap.uncompress();
+
+        auto store = snap.referencesMedia() ? &getMediaStore() : nullptr;
+        load(snap.getData() + sizeof(SnapshotHeader), store);
+
+        loginfo(SNP_DEBUG, "Restored boot state %016llx\n", key);
+
+    } catch (std::exception &exc) {
+
+        // Fall back to a regular boot
+        logwarn("Cannot restore boot state: %s\n", exc.what());
+        hardReset();
+    }
+}
+
+void
+Amiga::saveBootState()
+{
+    auto key = pendingBootState;
+    pendingBootState = 0;
+
+    try {
+
+        // Skip recording if the setup has changed after power-on
+        if (key == 0 || key != bootStateKey()) return;
+
+        auto path = bootStatePath(key);
+        auto tmp = path;
+        tmp += ".tmp";
+
+        fs::create_directories(path.parent_path());
+        Snapshot(*this, config.snapshotCompressor, &getMediaStore()).writeToFile(tmp);
+        fs::rename(tmp, path);
+
+        loginfo(SNP_DEBUG, "Recorded boot state %016llx\n", key);
+
+    } catch (std::exception &exc) {
+
+        logwarn("Cannot record boot state: %s\n", exc.what());
+    }
+}
+
+u64
+Amiga::bootStateKey()
+{
+    std::stringstream ss;
+
+    // Hash all configuration options
+    exportConfig(ss, false, { Class::Host });
+    auto str = ss.str();
+    auto result = Hashable::fnv64((const u8 *)str.data(), isize(str.size()));
+
+    // Hash the snapshot format, the Roms, and all inserted media
+    result = Hashable::fnvIt64(result, SNP_MAJOR << 16 | SNP_MINOR << 8 | SNP_SUBMINOR);
+    result = Hashable::fnvIt64(result, mem.romFingerprint());
+    result = Hashable::fnvIt64(result, mem.extFingerprint());
+    for (auto *drive : df) result = Hashable::fnvIt64(result, drive->diskFingerprint());
+    for (auto *drive : hd) result = Hashable::fnvIt64(result, drive->diskFingerprint());
+
+    return result ? result : 1;
+}
+
+fs::path
+Amiga::bootStatePath(u64 key)
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.vasnap", (unsigned long long)key);
+    return host.getMediaPath() / "boot" / name;
+}
+
 void
 Amiga::saveSnapshot(const fs::path &path)
 {
-    Snapshot(*this, config.snapshotCompressor).writeToFile(path);
+    auto store = config.snapshotMediaStore ? &getMediaStore() : nullptr;
+    Snapshot(*this, config.snapshotCompressor, store).writeToFile(path);
 }
 
 void
@@ -41,9 +41,11 @@
 #include "LogicAnalyzer.h"
 #include "OSDebugger.h"
 #include "RegressionTester.h"
+#include "Recorder.h"
 #include "RemoteManager.h"
 #include "RetroShell.h"
 #include "RshServer.h"
+#include "StreamExporter.h"
 #include "SerialPort.h"
 #include "MidiManager.h"
 #include "Snapshot.h"
@@ -78,9 +80,16 @@ class Amiga final : public CoreComponent {
         Opt::AMIGA_WARP_BOOT,
         Opt::AMIGA_WARP_MODE,
         Opt::AMIGA_VSYNC,
+        Opt::AMIGA_PACING,
+        Opt::AMIGA_SPIN_TIME,
+        Opt::AMIGA_CPU_CORE,
+        Opt::AMIGA_RT_PRIORITY,
         Opt::AMIGA_SPEED_BOOST,
         Opt::AMIGA_RUN_AHEAD,
+        Opt::AMIGA_SPECULATION,
         Opt::AMIGA_WS_COMPRESSION,
+        Opt::AMIGA_SNAP_MEDIA_STORE,
+        Opt::AMIGA_BOOT_CACHE,
     };
     
     // The current configuration
@@ -153,6 +162,8 @@ public:
     RemoteManager remoteManager = RemoteManager(*this);
     OSDebugger osDebugger = OSDebugger(*this);
     RegressionTester regressionTester = RegressionTester(*this);
+    StreamExporter streamExporter = StreamExporter(*this);
+    Recorder recorder = Recorder(*this);
 
     // Shortcuts
     FloppyDrive *df[4] = { &df0, &df1, &df2, &df3 };
@@ -262,6 +273,8 @@ public:
         CLONE(retroShell)
         CLONE(osDebugger)
         CLONE(regressionTester)
+        CLONE(streamExporter)
+        CLONE(recorder)
 
         CLONE(flags)
         CLONE(config)
@@ -403,6 +416,12 @@ public:
     // Called by the Emulator class in it's own update function
     void update(CmdQueue &queue);
 
+    // Checks if a command is a keyboard, mouse, or joystick event
+    static bool isInput(const Command &cmd);
+
+    // Feeds a keyboard, mouse, or joystick event into the emulator
+    void processInput(const Command &cmd);
+
     // Emulates a frame
     void computeFrame();
 
@@ -447,6 +466,45 @@ public:
     // Handling snapshots
     //
 
+private:
+
+    // Content-addressed store for disk and Rom data (created on demand)
+    std::unique_ptr<MediaStore> mediaStore;
+
+public:
+
+    // Returns the media store referenced by snapshots
+    MediaStore &getMediaStore();
+
+
+    //
+    // Caching boot states
+    //
+
+private:
+
+    // Key of the boot state waiting to be recorded (0 = none)
+    u64 pendingBootState = 0;
+
+public:
+
+    // Indicates whether a boot state is waiting to be recorded
+    bool awaitsBootState() const { return pendingBootState != 0; }
+
+    // Records the pending boot state in the boot cache
+    void saveBootState();
+
+private:
+
+    // Restores a cached boot state or prepares its recording
+    void restoreBootState();
+
+    // Computes the cache key from the configuration, Roms, and inserted media
+    u64 bootStateKey();
+
+    // Returns the location of a cached boot state
+    fs::path bootStatePath(u64 key);
+
 public:
 
     // Takes a snapshot
@@ -112,6 +112,37 @@ struct WarpEnum : Reflectable<WarpEnum, Warp>
     }
 };
 
+enum class Pacing : long
+{
+    PULSE,
+    HYBRID
+};
+
+struct PacingEnum : Reflectable<PacingEnum, Pacing>
+{
+    static constexpr long minVal = 0;
+    static constexpr long maxVal = long(Pacing::HYBRID);
+
+    static const char *_key(Pacing value)
+    {
+        switch (value) {
+
+            case Pacing::PULSE:  return "PULSE";
+            case Pacing::HYBRID: return "HYBRID";
+        }
+        return "???";
+    }
+    static const char *help(Pacing value)
+    {
+        switch (value) {
+
+            case Pacing::PULSE:  return "Wait for wakeup pulses from the host";
+            case Pacing::HYBRID: return "Sleep and spin until the next frame is due";
+        }
+        return "???";
+    }
+};
+
 enum class ConfigScheme : long
 {
     A1000_OCS_1MB,
@@ -333,9 +364,24 @@ typedef struct
     //! Vertical Synchronization
     bool vsync;
 
+    //! Frame pacing method
+    Pacing pacing;
+
+    //! Time in microseconds spent busy-waiting before a frame is due
+    isize spinTime;
+
+    //! CPU core the emulator thread is pinned to (-1 = no pinning)
+    isize cpuCore;
+
+    //! Indicates whether the emulator thread requests real-time scheduling
+    bool rtPriority;
+
     //! Number of run-ahead frames (0 = run-ahead is disabled)
     isize runAhead;
 
+    //! Number of speculative run-ahead instances (0 = run ahead serially)
+    isize speculation;
+
     //! Enable auto-snapshots
     bool autoSnapshots;
 
@@ -347,6 +393,12 @@ typedef struct
 
     //! Indicates whether workspace media files should be compressed
     bool compressWorkspaces;
+
+    //! Indicates whether snapshots reference disk and Rom data in the media store
+    bool snapshotMediaStore;
+
+    //! Indicates whether boot states are cached and restored on power-on
+    bool bootCache;
 }
 AmigaConfig;
 
@@ -385,6 +437,7 @@ constexpr u32 COPPERWP_REACHED   = (1 << 10);
 constexpr u32 AUTO_SNAPSHOT      = (1 << 11);
 constexpr u32 USER_SNAPSHOT      = (1 << 12);
 constexpr u32 SYNC_THREAD        = (1 << 13);
+constexpr u32 BOOT_STATE         = (1 << 14);
 };
 
 }
@@ -1267,6 +1267,8 @@ Denise::hsyncHandler(isize vpos)
     assert(agnus.pos.h == 0x12);
     assert(vpos >= 0 && vpos <= VPOS_MAX);
 
+    utl::TraceSpan trace("denise", "renderLine");
+
     //
     // Finish the current line
     //
@@ -306,6 +306,11 @@ PixelEngine::swapBuffers()
 
     activeBuffer = newActiveBuffer;
 
+    // Publish the completed frame
+    if (streamExporter.isActive()) streamExporter.exportFrame(emuTexture[oldActiveBuffer]);
+    if (recorder.isRecording()) recorder.recordFrame(emuTexture[oldActiveBuffer]);
+    if (remoteManager.frameServer.wantsFrame()) remoteManager.frameServer.captureFrame(emuTexture[oldActiveBuffer]);
+
     emulator.unlockTexture();
 }
 
@@ -362,9 +362,9 @@ Memory::operator << (SerCounter &worker)
     << slowSize
     << fastSize;
 
-    worker.count += romSize;
-    worker.count += womSize;
-    worker.count += extSize;
+    worker.media(romSize);
+    worker.media(womSize);
+    worker.media(extSize);
     worker.count += chipSize;
     worker.count += slowSize;
     worker.count += fastSize;
@@ -408,9 +408,9 @@ Memory::operator << (SerReader &worker)
     allocFast(fastSize, false);
 
     // Load memory contents
-    worker.copy(rom, romSize);
-    worker.copy(wom, womSize);
-    worker.copy(ext, extSize);
+    worker.media(rom, romSize);
+    worker.media(wom, womSize);
+    worker.media(ext, extSize);
     worker.copy(chip, chipSize);
     worker.copy(slow, slowSize);
     worker.copy(fast, fastSize);
@@ -439,9 +439,9 @@ Memory::operator << (SerWriter &worker)
     << fastSize;
 
     // Save memory contents
-    worker.copy(rom, romSize);
-    worker.copy(wom, womSize);
-    worker.copy(ext, extSize);
+    worker.media(rom, romSize);
+    worker.media(wom, womSize);
+    worker.media(ext, extSize);
     worker.copy(chip, chipSize);
     worker.copy(slow, slowSize);
     worker.copy(fast, fastSize);
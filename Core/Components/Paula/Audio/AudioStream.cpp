@@ -13,153 +13,135 @@
 
 namespace vamiga {
 
+AudioStream::AudioStream(isize capacity)
+{
+    resize(capacity);
+}
+
+AudioStream::~AudioStream()
+{
+    delete[] elements;
+}
+
 void
-AudioStream::wipeOut()
+AudioStream::resize(isize capacity)
 {
-    {   SYNCHRONIZED
+    assert(capacity > 1 && capacity <= storageSize);
+    this->capacity.store(capacity, std::memory_order_relaxed);
+}
 
-        clear(SamplePair{0,0});
-    }
+isize
+AudioStream::count() const
+{
+    auto begin = std::max(r.load(std::memory_order_acquire), skipPos.load(std::memory_order_relaxed));
+    return isize(w.load(std::memory_order_acquire) - begin);
 }
 
 void
-AudioStream::eliminateCracks()
+AudioStream::wipeOut()
 {
-    {   SYNCHRONIZED
+    // Ask the consumer to skip all samples written so far
+    skipPos.store(end(), std::memory_order_release);
+}
 
-        loginfo(AUDVOL_DEBUG, "Eliminating cracks (%ld samples)...\n", count());
+void
+AudioStream::eliminateCracks()
+{
+    loginfo(AUDVOL_DEBUG, "Eliminating cracks (%ld samples)...\n", count());
 
-        float scale = 1.0f;
-        float delta = 1.0f / float(count());
+    // Ask the consumer to fade out all samples written so far
+    fadePos.store(end(), std::memory_order_release);
+}
 
-        // Rescale the existing samples
-        for (isize i = begin(); i != end(); i = next(i)) {
+void
+AudioStream::alignWritePtr()
+{
+    auto target = cap() / 2;
 
-            scale -= delta;
-            assert(scale >= -0.1 && scale < 1.0);
+    if (auto cnt = count(); cnt < target) {
 
-            elements[i].l *= scale;
-            elements[i].r *= scale;
-        }
+        // Pad the buffer with silence
+        for (isize i = cnt; i < target; i++) write(SamplePair { 0, 0 });
 
-        // Wipe out the rest of the buffer
-        for (isize i = end(); i != begin(); i = next(i)) {
+    } else {
 
-            elements[i] = { 0, 0 };
-        }
+        // Ask the consumer to skip the oldest samples
+        skipPos.store(end() - target, std::memory_order_release);
     }
 }
 
-void
-AudioStream::alignWritePtr()
+bool
+AudioStream::alignIfRequested()
 {
-    {   SYNCHRONIZED
+    if (!alignRequest.exchange(false, std::memory_order_acquire)) return false;
 
-        align(cap() / 2);
-    }
+    alignWritePtr();
+    return true;
 }
 
-isize
-AudioStream::copyMono(float *buffer, isize n)
+template <typename F> isize
+AudioStream::copy(isize n, F emit)
 {
-    {   SYNCHRONIZED
+    // Process pending requests from the producer
+    auto pos = std::max(r.load(std::memory_order_relaxed), skipPos.load(std::memory_order_acquire));
 
-        // If a buffer underflow occurs ...
-        if (auto cnt = count(); cnt < n) {
+    if (auto fade = fadePos.exchange(0, std::memory_order_acquire); fade > pos) {
 
-            // ... copy all we have while stepwise lowering the volume ...
-            for (isize i = 0; i < cnt; i++) {
+        fadeEnd = fade;
+        fadeLength = fade - pos;
+    }
 
-                auto pair = read();
-                *buffer++ = (pair.l + pair.r) * float(cnt - i) / float(cnt);
-            }
-            assert(isEmpty());
+    // Determine the number of available samples
+    auto cnt = isize(std::min(w.load(std::memory_order_acquire) - pos, i64(n)));
 
-            // ... and fill the rest with zeroes.
-            for (isize i = cnt; i < n; i++) *buffer++ = 0;
+    for (isize i = 0; i < cnt; i++, pos++) {
 
-            return cnt;
-        }
+        auto pair = (*this)[pos];
 
-        // The standard case: The buffer contains enough samples
-        for (isize i = 0; i < n; i++) {
+        // Fade out the samples that were present when eliminating cracks
+        if (pos < fadeEnd) {
 
-            auto sample = read();
-            buffer[i] = 0.5f * (sample.l + sample.r);
+            auto scale = float(fadeEnd - pos - 1) / float(fadeLength);
+            pair.l *= scale;
+            pair.r *= scale;
         }
 
-        return n;
-    }
-}
-
-isize
-AudioStream::copyStereo(float *left, float *right, isize n)
-{
-    {   SYNCHRONIZED
+        // If a buffer underflow occurs, stepwise lower the volume
+        if (cnt < n) {
 
-        // If a buffer underflow occurs ...
-        if (auto cnt = count(); cnt < n) {
+            auto scale = float(cnt - i) / float(cnt);
+            pair.l *= scale;
+            pair.r *= scale;
+        }
 
-            // ... copy all we have while stepwise lowering the volume ...
-            for (isize i = 0; i < cnt; i++) {
+        emit(pair);
+    }
 
-                auto pair = read();
-                *left++ = pair.l * float(cnt - i) / float(cnt);
-                *right++ = pair.r * float(cnt - i) / float(cnt);
-            }
-            assert(isEmpty());
+    // Hand the consumed slots back to the producer
+    r.store(pos, std::memory_order_release);
 
-            // ... and fill the rest with zeroes.
-            for (isize i = cnt; i < n; i++) *left++ = *right++ = 0;
+    // Fill the rest with zeroes
+    for (isize i = cnt; i < n; i++) emit(SamplePair { 0, 0 });
 
-            return cnt;
-        }
-
-        // The standard case: The buffer contains enough samples
-        for (isize i = 0; i < n; i++) {
+    return cnt;
+}
 
-            auto sample = read();
-            left[i] = sample.l;
-            right[i] = sample.r;
-        }
+isize
+AudioStream::copyMono(float *buffer, isize n)
+{
+    return copy(n, [&](SamplePair pair) { *buffer++ = 0.5f * (pair.l + pair.r); });
+}
 
-        return n;
-    }
+isize
+AudioStream::copyStereo(float *left, float *right, isize n)
+{
+    return copy(n, [&](SamplePair pair) { *left++ = pair.l; *right++ = pair.r; });
 }
 
 isize
 AudioStream::copyInterleaved(float *buffer, isize n)
 {
-    {   SYNCHRONIZED
-
-        // If a buffer underflow occurs ...
-        if (auto cnt = count(); cnt < n) {
-
-            // ... copy all we have while stepwise lowering the volume ...
-            for (isize i = 0; i < cnt; i++) {
-
-                auto pair = read();
-                *buffer++ = pair.l * float(cnt - i) / float(cnt);
-                *buffer++ = pair.r * float(cnt - i) / float(cnt);
-            }
-            assert(isEmpty());
-
-            // ... and fill the rest with zeroes.
-            for (isize i = cnt; i < n; i++) { *buffer++ = 0; *buffer++ = 0; }
-
-            return cnt;
-        }
-
-        // The standard case: The buffer contains enough samples
-        for (isize i = 0; i < n; i++) {
-
-            auto sample = read();
-            *buffer++ = sample.l;
-            *buffer++ = sample.r;
-        }
-
-        return n;
-    }
+    return copy(n, [&](SamplePair pair) { *buffer++ = pair.l; *buffer++ = pair.r; });
 }
 
 void 
@@ -180,22 +162,20 @@ float
 AudioStream::drawL(u32 *buffer, isize width, isize height, float highest, u32 color) const
 {
     return draw(buffer, width, height, highest,
-                [this](float x) { return std::abs(current(isize(float(cap()) * x)).l); }, color);
+                [this](float x) { return std::abs((*this)[r.load(std::memory_order_relaxed) + i64(float(cap()) * x)].l); }, color);
 }
 
 float
 AudioStream::drawR(u32 *buffer, isize width, isize height, float highest, u32 color) const
 {
     return draw(buffer, width, height, highest,
-                [this](float x) { return std::abs(current(isize(float(cap()) * x)).r); }, color);
+                [this](float x) { return std::abs((*this)[r.load(std::memory_order_relaxed) + i64(float(cap()) * x)].r); }, color);
 }
 
 float
 AudioStream::draw(u32 *buffer, isize width, isize height, float highest,
                   std::function<float(float x)> data, u32 color) const
 {
-    SYNCHRONIZED
-    
     float newHighestAmplitude = 0.001f;
 
     // Clear buffer
@@ -11,7 +11,8 @@
 
 #include "CoreObject.h"
 #include "utl/storage.h"
-#include "utl/concurrency.h"
+#include <algorithm>
+#include <atomic>
 
 namespace vamiga {
 
@@ -36,13 +37,127 @@ struct SamplePair
 // AudioStream
 //
 
-class AudioStream : public CoreObject, public Synchronizable, public utl::ResizableRingBuffer<SamplePair> {
+/* The stream is a lock-free single-producer / single-consumer ring buffer. The
+ * emulator thread is the only producer and the audio thread of the host is
+ * the only consumer. Both sides communicate through two stream positions that
+ * grow monotonically. The write position is only modified by the producer and
+ * the read position is only modified by the consumer. The positions live in
+ * separate cache lines to prevent false sharing.
+ *
+ * Operations that need to move the pointer of the other side are turned into
+ * requests. The producer asks the consumer to skip samples (to resolve an
+ * overflow) or to fade out the buffered samples (to eliminate cracks). The
+ * consumer asks the producer to refill the buffer with silence (to resolve an
+ * underflow).
+ *
+ * The element storage is large enough for the largest supported capacity.
+ * Hence, changing the capacity never reallocates the storage.
+ */
+class AudioStream : public CoreObject {
+
+    // Size of the element storage (a power of two)
+    static constexpr isize storageSize = 65536;
+
+    // Size of a cache line
+    static constexpr isize cacheLine = 64;
+
+    // Element storage
+    SamplePair *elements = new SamplePair[storageSize]();
+
+    // Usable capacity
+    std::atomic<isize> capacity;
+
+    // Position of the next sample to be written (modified by the producer)
+    alignas(cacheLine) std::atomic<i64> w = 0;
+
+    // Start of the unconsumed samples as seen by the producer when it last
+    // checked (samples below the skip position count as consumed)
+    i64 cachedR = 0;
+
+    // Position up to which the consumer is asked to skip samples
+    std::atomic<i64> skipPos = 0;
+
+    // Position up to which the consumer is asked to fade out samples
+    std::atomic<i64> fadePos = 0;
+
+    // Position of the next sample to be read (modified by the consumer)
+    alignas(cacheLine) std::atomic<i64> r = 0;
+
+    // The fade-out currently performed by the consumer
+    i64 fadeEnd = 0;
+    i64 fadeLength = 0;
+
+    // Set by the consumer to ask the producer for a pointer alignment
+    std::atomic<bool> alignRequest = false;
 
 public:
 
     const char *objectName() const override { return "AudioStream"; }
 
-    // Initializes the ring buffer with zeroes
+
+    //
+    // Initializing
+    //
+
+    AudioStream(isize capacity);
+    ~AudioStream();
+
+    AudioStream(const AudioStream &) = delete;
+    AudioStream& operator= (const AudioStream &) = delete;
+
+    // Changes the capacity of the buffer
+    void resize(isize capacity);
+
+
+    //
+    // Querying the fill status
+    //
+
+    isize cap() const { return capacity.load(std::memory_order_relaxed); }
+    isize count() const;
+    isize free() const { return std::max(cap() - count() - 1, isize(0)); }
+    double fillLevel() const { return std::min(double(count()) / double(cap()), 1.0); }
+    bool isEmpty() const { return count() == 0; }
+
+
+    //
+    // Producing samples (emulator thread)
+    //
+
+    // Appends a sample (the sample is dropped if the storage is exhausted)
+    void write(SamplePair sample)
+    {
+        auto pos = w.load(std::memory_order_relaxed);
+
+        if (pos - cachedR >= storageSize) {
+
+            cachedR = std::max(r.load(std::memory_order_acquire),
+                               skipPos.load(std::memory_order_relaxed));
+            if (pos - cachedR >= storageSize) return;
+        }
+        elements[pos & (storageSize - 1)] = sample;
+        w.store(pos + 1, std::memory_order_release);
+    }
+
+    // Returns the position of the next sample to be written
+    i64 end() const { return w.load(std::memory_order_relaxed); }
+
+    // Returns the sample at the specified stream position
+    const SamplePair &operator[](i64 pos) const { return elements[pos & (storageSize - 1)]; }
+
+    // Returns the most recently written sample
+    SamplePair latest() const { return isEmpty() ? SamplePair{} : (*this)[end() - 1]; }
+
+    // Passes the latest samples to the provided function (oldest first)
+    template <typename F> void copyLatest(isize count, F fn) const
+    {
+        auto last = end();
+        for (auto pos = last - std::clamp(count, isize(0), cap() - 1); pos < last; pos++) {
+            fn((*this)[pos]);
+        }
+    }
+
+    // Discards all samples
     void wipeOut();
 
     // Rescales the existing samples to gradually fade out
@@ -51,17 +166,17 @@ public:
     // Puts the write pointer somewhat ahead of the read pointer
     void alignWritePtr();
 
-    
-    //
-    // Initializing
-    //
-    AudioStream(isize capacity) : utl::ResizableRingBuffer<SamplePair>(capacity) { }
+    // Performs a pointer alignment if the consumer has asked for it
+    bool alignIfRequested();
+
 
-    
     //
-    // Copying data
+    // Consuming samples (audio thread)
     //
 
+    // Asks the producer to align the write pointer
+    void requestAlignment() { alignRequest.store(true, std::memory_order_release); }
+
     /* Copies n audio samples into a memory buffer. These functions mark the
      * final step in the audio pipeline. They are used to copy the generated
      * sound samples into the buffers of the native sound device. In additon
@@ -72,6 +187,12 @@ public:
     isize copyStereo(float *left, float *right, isize n);
     isize copyInterleaved(float *buffer, isize n);
 
+private:
+
+    // Copies n samples by passing them to the provided function
+    template <typename F> isize copy(isize n, F emit);
+
+public:
 
     //
     // Visualizing the waveform
@@ -80,7 +201,8 @@ public:
     /* Plots a graphical representation of the waveform. Returns the highest
      * amplitute that was found in the ringbuffer. To implement auto-scaling,
      * pass the returned value as parameter highestAmplitude in the next call
-     * to this function.
+     * to this function. The samples are read without synchronization, which
+     * means that the plot may contain samples that are being overwritten.
      */
     void drawL(u32 *buffer, isize width, isize height, u32 color) const;
     void drawR(u32 *buffer, isize width, isize height, u32 color) const;
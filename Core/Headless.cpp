@@ -13,9 +13,13 @@
 #include "Amiga.h"
 #include "Script.h"
 #include "DiagRom.h"
+#include "Farm.h"
 #include "utl/chrono.h"
 #include "utl/support.h"
 #include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <thread>
 
 int main(int argc, char *argv[])
 {
@@ -25,13 +29,21 @@ int main(int argc, char *argv[])
         
     } catch (vamiga::SyntaxError &e) {
         
-        std::cout << "Usage: VAmigaHeadless [-fsdvm] [<script>]" << std::endl;
+        std::cout << "Usage: VAmigaHeadless [-fsdvm] [-c <path>] [<script>]" << std::endl;
+        std::cout << "       VAmigaHeadless -r [-j <jobs>] [-R <folder>] <script> ..." << std::endl;
+        std::cout << "       VAmigaHeadless -F <manifest> [-j <workers>] [-R <folder>]" << std::endl;
         std::cout << std::endl;
         std::cout << "       -f or --footprint   Report the size of objects" << std::endl;
         std::cout << "       -s or --smoke       Run smoke tests to test the build" << std::endl;
         std::cout << "       -d or --diagnose    Run DiagRom in the background" << std::endl;
         std::cout << "       -v or --verbose     Print the executed script lines" << std::endl;
         std::cout << "       -m or --messages    Observe the message queue" << std::endl;
+        std::cout << "       -c or --capture     Record the output to <path>.y4m and <path>.wav" << std::endl;
+        std::cout << "       -t or --trace       Write a Chrome trace-event timeline to <path>" << std::endl;
+        std::cout << "       -r or --regression  Run regression tests in parallel" << std::endl;
+        std::cout << "       -F or --farm        Run all scripts of a manifest on a shared worker pool" << std::endl;
+        std::cout << "       -j or --jobs        Number of tests running concurrently" << std::endl;
+        std::cout << "       -R or --reference   Folder with reference images" << std::endl;
         std::cout << "       <script>            Execute a custom script" << std::endl;
         std::cout << std::endl;
         
@@ -70,6 +82,8 @@ Headless::main(int argc, char *argv[])
     if (keys.find("footprint") != keys.end())   { reportSize(); }
     if (keys.find("smoke") != keys.end())       { runScript(smokeTestScript); }
     if (keys.find("diagnose") != keys.end())    { runScript(selfTestScript); }
+    if (keys.find("regression") != keys.end())  { runRegression(); return returnCode; }
+    if (keys.find("farm") != keys.end())        { runFarm(); return returnCode; }
     if (keys.find("arg1") != keys.end())        { runScript(keys["arg1"]); }
 
     return returnCode;
@@ -93,6 +107,40 @@ Headless::parseArguments(int argc, char *argv[])
             if (arg == "-d" || arg == "--diagnose")  { keys["diagnose"] = "1"; continue; }
             if (arg == "-v" || arg == "--verbose")   { keys["verbose"] = "1"; continue; }
             if (arg == "-m" || arg == "--messages")  { keys["messages"] = "1"; continue; }
+            if (arg == "-r" || arg == "--regression") { keys["regression"] = "1"; continue; }
+
+            if (arg == "-j" || arg == "--jobs" || arg == "-R" || arg == "--reference") {
+
+                if (++i == argc) throw SyntaxError("Missing argument for '" + arg + "'");
+
+                auto key = arg == "-j" || arg == "--jobs" ? "jobs" : "reference";
+                keys[key] = string(argv[i]);
+                continue;
+            }
+
+            if (arg == "-c" || arg == "--capture") {
+
+                if (++i == argc) throw SyntaxError("Missing argument for '" + arg + "'");
+
+                keys["capture"] = fs::absolute(fs::path(argv[i])).string();
+                continue;
+            }
+
+            if (arg == "-t" || arg == "--trace") {
+
+                if (++i == argc) throw SyntaxError("Missing argument for '" + arg + "'");
+
+                keys["trace"] = fs::absolute(fs::path(argv[i])).string();
+                continue;
+            }
+
+            if (arg == "-F" || arg == "--farm") {
+
+                if (++i == argc) throw SyntaxError("Missing argument for '" + arg + "'");
+
+                keys["farm"] = fs::absolute(fs::path(argv[i])).string();
+                continue;
+            }
 
             throw SyntaxError("Invalid option '" + arg + "'");
         }
@@ -108,14 +156,32 @@ Headless::parseArguments(int argc, char *argv[])
 void
 Headless::checkArguments()
 {
-    // At most one file must be specified
-    if (keys.find("arg2") != keys.end()) {
+    bool regression = keys.find("regression") != keys.end();
+
+    // At most one file must be specified (except for regression testing)
+    if (!regression && keys.find("arg2") != keys.end()) {
         throw SyntaxError("More than one script file is given");
     }
 
-    // The input file must exist
-    if (keys.find("arg1") != keys.end() && !utl::fileExists(keys["arg1"])) {
-        throw SyntaxError("File " + keys["arg1"] + " does not exist");
+    // All input files must exist
+    for (isize i = 1; keys.find("arg" + std::to_string(i)) != keys.end(); i++) {
+
+        auto &file = keys["arg" + std::to_string(i)];
+        if (!utl::fileExists(file)) throw SyntaxError("File " + file + " does not exist");
+    }
+
+    // The manifest must exist
+    if (keys.find("farm") != keys.end()) {
+
+        if (regression) throw SyntaxError("Options -r and -F are mutually exclusive");
+        if (!utl::fileExists(keys["farm"])) throw SyntaxError("File " + keys["farm"] + " does not exist");
+    }
+
+    // The job count must be a positive number
+    if (keys.find("jobs") != keys.end()) {
+
+        try { if (std::stoi(keys["jobs"]) > 0) return; } catch (...) { }
+        throw SyntaxError("Invalid job count '" + keys["jobs"] + "'");
     }
 }
 
@@ -143,6 +209,14 @@ Headless::runScript(const fs::path &path)
     // Redirect shell output to the console in verbose mode
     if (keys.find("verbose") != keys.end()) vamiga.retroShell.setStream(std::cout);
 
+    // Record the emulator output if requested
+    if (keys.find("capture") != keys.end()) {
+        vamiga.amiga.amiga->recorder.startRecording(keys["capture"]);
+    }
+
+    // Record a timeline if requested
+    if (keys.find("trace") != keys.end()) utl::Tracer::start();
+
     // Launch the emulator thread
     vamiga.launch(this, vamiga::process);
 
@@ -150,6 +224,273 @@ Headless::runScript(const fs::path &path)
     const auto timeout = utl::Time::seconds(500.0);
     vamiga.retroShell.execScript(path);
     waitForWakeUp(timeout);
+
+    // Finalize the recording
+    if (keys.find("capture") != keys.end()) {
+
+        vamiga.halt();
+        vamiga.amiga.amiga->recorder.stopRecording();
+        checkRecording(vamiga);
+    }
+
+    // Save the timeline
+    if (keys.find("trace") != keys.end()) {
+
+        utl::Tracer::stop();
+        utl::Tracer::save(fs::path(keys["trace"]));
+    }
+}
+
+void
+Headless::checkRecording(VAmiga &vamiga)
+{
+    auto path = fs::path(keys["capture"] + ".wav");
+    auto file = std::ifstream(path, std::ios::binary);
+
+    u8 header[44] = { };
+    file.read((char *)header, sizeof(header));
+
+    auto get32 = [&](isize i) { return u32(header[i] | header[i + 1] << 8 | header[i + 2] << 16 | header[i + 3] << 24); };
+
+    // The recorder writes the nominal sample rate and resamples the audio
+    // stream to match the duration of the recorded frames exactly. Only the
+    // first frames (recorded before the audio pipeline is filled) may lack
+    // audio data.
+    auto &recorder = vamiga.amiga.amiga->recorder;
+    auto stats = recorder.getStats();
+    auto expected = u32(std::round(vamiga.amiga.amiga->audioPort.getSampleRate()));
+    auto rate = get32(24);
+    auto samples = i64(get32(40) / sizeof(SamplePair));
+    auto nominal = i64(std::llround(double(stats.writtenFrames) * recorder.samplesPerFrame()));
+
+    if (!file || stats.writtenFrames == 0 || samples != stats.writtenSamples) {
+
+        std::cout << "Failed to verify " << path.string() << std::endl;
+        returnCode = 1;
+
+    } else if (rate != expected || samples != nominal) {
+
+        std::cout << "Recorded " << samples << " samples at " << rate << " Hz in " << stats.writtenFrames;
+        std::cout << " frames (expected " << nominal << " samples at " << expected << " Hz)" << std::endl;
+        returnCode = 1;
+
+    } else if (double(stats.paddedSamples) > 4 * recorder.samplesPerFrame()) {
+
+        std::cout << "Recorded " << stats.paddedSamples << " samples without audio data" << std::endl;
+        returnCode = 1;
+    }
+}
+
+void
+Headless::runRegression()
+{
+    // Create a job for each test script
+    std::vector<RegressionJob> jobs(keys.size());
+    isize count = 0;
+
+    for (isize i = 1; keys.find("arg" + std::to_string(i)) != keys.end(); i++) {
+        jobs[count++].script = keys["arg" + std::to_string(i)];
+    }
+
+    // Determine the number of worker threads
+    isize workers = keys.find("jobs") != keys.end() ?
+    std::stoi(keys["jobs"]) : std::max(1U, std::thread::hardware_concurrency());
+
+    // Run all tests on a pool of worker threads
+    std::atomic<isize> next = 0;
+    std::vector<std::thread> pool;
+
+    for (isize i = 0; i < std::min(workers, count); i++) {
+
+        pool.emplace_back([&]() {
+
+            for (isize nr = next++; nr < count; nr = next++) runRegression(jobs[nr]);
+        });
+    }
+    for (auto &thread : pool) thread.join();
+
+    printSummary(jobs, count);
+}
+
+void
+Headless::runRegression(RegressionJob &job)
+{
+    static std::mutex mutex;
+    static const auto timeout = utl::Time::seconds(500.0);
+
+    std::unique_ptr<VAmiga> vamiga;
+
+    {   // Emulator instances are created one after another
+        std::lock_guard<std::mutex> guard(mutex);
+
+        vamiga = std::make_unique<VAmiga>();
+
+        // Compare test images in memory if reference images are provided
+        if (keys.find("reference") != keys.end()) {
+            vamiga->amiga.amiga->regressionTester.referencePath = fs::absolute(keys["reference"]);
+        }
+
+        vamiga->launch(&job, [](const void *listener, Message msg) {
+            ((RegressionJob *)listener)->process(msg);
+        });
+    }
+
+    // Run the test
+    job.clock.restart();
+    vamiga->retroShell.execScript(job.script);
+    job.waitForWakeUp(timeout);
+
+    // Record the result
+    job.evaluate(*vamiga);
+
+    {   std::lock_guard<std::mutex> guard(mutex);
+        vamiga = nullptr;
+    }
+}
+
+void
+Headless::runFarm()
+{
+    static const auto timeout = utl::Time::seconds(500.0);
+
+    auto manifest = fs::path(keys["farm"]);
+
+    // Parse the manifest (one script per line, optionally followed by @<worker>)
+    std::vector<std::pair<fs::path, isize>> entries;
+    std::ifstream stream(manifest);
+
+    for (string line; std::getline(stream, line); ) {
+
+        std::istringstream ss(line);
+        string script, hint;
+
+        if (!(ss >> script) || script[0] == '#') continue;
+
+        auto path = manifest.parent_path() / script;
+        if (!utl::fileExists(path)) throw SyntaxError("File " + path.string() + " does not exist");
+
+        if (ss >> hint) {
+
+            try { entries.push_back({ path, std::stol(hint.substr(hint[0] == '@')) }); continue; } catch (...) { }
+            throw SyntaxError("Invalid worker hint '" + hint + "'");
+        }
+        entries.push_back({ path, -1 });
+    }
+
+    // Create a job for each script
+    isize count = isize(entries.size());
+    std::vector<RegressionJob> jobs(count);
+
+    for (isize i = 0; i < count; i++) {
+
+        jobs[i].script = entries[i].first;
+        jobs[i].hint = entries[i].second;
+    }
+
+    // Create the worker pool
+    isize workers = keys.find("jobs") != keys.end() ?
+    std::stoi(keys["jobs"]) : std::max(1U, std::thread::hardware_concurrency());
+
+    Farm farm(workers);
+
+    // Create an emulator instance for each job and hand it over to the farm
+    std::vector<std::unique_ptr<VAmiga>> instances;
+
+    for (isize i = 0; i < count; i++) {
+
+        auto &vamiga = instances.emplace_back(std::make_unique<VAmiga>());
+
+        if (keys.find("reference") != keys.end()) {
+            vamiga->amiga.amiga->regressionTester.referencePath = fs::absolute(keys["reference"]);
+        }
+
+        vamiga->launch(&jobs[i], [](const void *listener, Message msg) {
+            ((RegressionJob *)listener)->process(msg);
+        }, farm, jobs[i].hint);
+
+        jobs[i].clock.restart();
+        vamiga->retroShell.execScript(jobs[i].script);
+    }
+
+    // Wait for all jobs to finish
+    auto deadline = utl::Time::now() + timeout;
+
+    for (isize i = 0; i < count; i++) {
+
+        jobs[i].waitForWakeUp(std::max(deadline - utl::Time::now(), utl::Time(0)));
+        jobs[i].evaluate(*instances[i]);
+    }
+
+    // Shut down all instances
+    instances.clear();
+
+    printSummary(jobs, count);
+}
+
+void
+Headless::printSummary(const std::vector<RegressionJob> &jobs, isize count)
+{
+    // Print a summary in JSON format
+    isize failed = 0;
+
+    std::cout << "{" << std::endl << "  \"tests\": [" << std::endl;
+
+    for (isize i = 0; i < count; i++) {
+
+        auto &job = jobs[i];
+        if (job.status != "pass") failed++;
+
+        std::cout << "    { ";
+        std::cout << "\"script\": \"" << jsonEscaped(job.script.string()) << "\", ";
+        std::cout << "\"status\": \"" << jsonEscaped(job.status) << "\", ";
+        std::cout << "\"exitCode\": " << job.exitCode << ", ";
+        std::cout << "\"hash\": \"" << std::hex << std::setw(16) << std::setfill('0') << job.hash << "\", ";
+        std::cout << std::dec << std::setfill(' ');
+        std::cout << "\"seconds\": " << std::fixed << std::setprecision(2) << job.seconds;
+        std::cout << " }" << (i + 1 < count ? "," : "") << std::endl;
+    }
+
+    std::cout << "  ]," << std::endl;
+    std::cout << "  \"passed\": " << count - failed << "," << std::endl;
+    std::cout << "  \"failed\": " << failed << std::endl;
+    std::cout << "}" << std::endl;
+
+    returnCode = failed ? 1 : 0;
+}
+
+void
+RegressionJob::process(Message msg)
+{
+    switch (msg.type) {
+
+        case Msg::RSH_ERROR:
+
+            status = "error";
+            seconds = clock.stop().asSeconds();
+            wakeUp();
+            break;
+
+        case Msg::ABORT:
+
+            status = "pass";
+            exitCode = msg.value;
+            seconds = clock.stop().asSeconds();
+            wakeUp();
+            break;
+
+        default:
+            break;
+    }
+}
+
+void
+RegressionJob::evaluate(VAmiga &vamiga)
+{
+    auto &tester = vamiga.amiga.amiga->regressionTester;
+
+    if (status == "pass" && (tester.mismatch || exitCode)) status = "fail";
+    if (status == "timeout") seconds = clock.stop().asSeconds();
+    hash = tester.textureHash;
 }
 
 void
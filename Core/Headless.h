@@ -22,6 +22,37 @@ struct SyntaxError : public std::runtime_error {
 // The message listener
 void process(const void *listener, Message msg);
 
+// A single regression test executed by the parallel test runner
+struct RegressionJob : Wakeable {
+
+    // The test script
+    fs::path script;
+
+    // Test outcome ("pass", "fail", "error", or "timeout")
+    string status = "timeout";
+
+    // Return code reported by the test
+    i64 exitCode = 0;
+
+    // Hash value of the test image
+    u64 hash = 0;
+
+    // Execution time in seconds
+    double seconds = 0.0;
+
+    // Preferred worker thread in farm mode (-1 = no preference)
+    isize hint = -1;
+
+    // Measures the execution time
+    utl::Clock clock;
+
+    // Processes an incoming message
+    void process(Message msg);
+
+    // Evaluates the test result after the script has terminated
+    void evaluate(VAmiga &vamiga);
+};
+
 class Headless : Wakeable {
 
     static const char *selfTestScript[];
@@ -55,6 +86,19 @@ private:
     void runScript(const char **script);
     void runScript(const fs::path &path);
 
+    // Checks if the recorded audio stream covers the emulated time
+    void checkRecording(VAmiga &vamiga);
+
+    // Runs all specified scripts as regression tests in parallel
+    void runRegression();
+    void runRegression(RegressionJob &job);
+
+    // Runs all jobs of a manifest on a shared pool of worker threads
+    void runFarm();
+
+    // Prints the results of a test run in JSON format
+    void printSummary(const std::vector<RegressionJob> &jobs, isize count);
+
     
     //
     // Running
@@ -81,6 +81,9 @@ enum class Cmd : long
     
     // RetroShell
     RSH_EXECUTE,            ///< Execute a script command
+
+    // Remote servers
+    RPC_EXECUTE,            ///< Process pending JSON-RPC requests
     
     // Experimental
     FUNC,
@@ -148,6 +151,8 @@ struct CmdEnum : Reflectable<CmdEnum, Cmd> {
             case Cmd::DSK_UNMODIFIED:        return "DSK_UNMODIFIED";
                 
             case Cmd::RSH_EXECUTE:           return "RSH_EXECUTE";
+
+            case Cmd::RPC_EXECUTE:           return "RPC_EXECUTE";
                 
             case Cmd::FUNC:                  return "FUNC";
             case Cmd::FOCUS:                 return "FOCUS";
@@ -213,10 +213,10 @@ CoreComponent::unfocus()
 }
 
 isize
-CoreComponent::size(bool recursive)
+CoreComponent::size(bool recursive, MediaStore *store)
 {
     // Count elements
-    SerCounter counter;
+    SerCounter counter(store);
     *this << counter;
     isize result = counter.count;
 
@@ -224,7 +224,7 @@ CoreComponent::size(bool recursive)
     result += 16;
 
     // Add size of subcomponents if requested
-    if (recursive) for (CoreComponent *c : subComponents) { result += c->size(); }
+    if (recursive) for (CoreComponent *c : subComponents) { result += c->size(true, store); }
 
     return result;
 }
@@ -245,11 +245,11 @@ CoreComponent::reset(bool hard)
 }
 
 isize
-CoreComponent::load(const u8 *buf)
+CoreComponent::load(const u8 *buf, MediaStore *store)
 {
     isize result = 0;
 
-    postorderWalk([this, buf, &result](CoreComponent *c) {
+    postorderWalk([this, buf, store, &result](CoreComponent *c) {
 
         const u8 *ptr = buf + result;
 
@@ -258,7 +258,7 @@ CoreComponent::load(const u8 *buf)
         auto hash = read64(ptr);
 
         // Load the internal state of this component
-        SerReader reader(ptr); *c << reader;
+        SerReader reader(ptr, store); *c << reader;
 
         // Determine the number of loaded bytes
         auto count = u64(reader.ptr - (buf + result));
@@ -283,34 +283,34 @@ CoreComponent::load(const u8 *buf)
 }
 
 isize
-CoreComponent::save(u8 *buffer)
+CoreComponent::save(u8 *buffer, MediaStore *store)
 {
     isize result = 0;
 
-    postorderWalk([this, buffer, &result](CoreComponent *c) {
+    postorderWalk([this, buffer, store, &result](CoreComponent *c) {
 
         u8 *ptr = buffer + result;
 
         // Save the size and the checksum for this component
-        write64(ptr, c->size(false));
+        write64(ptr, c->size(false, store));
         write64(ptr, c->checksum(false));
 
         // Save the internal state of this component
-        SerWriter writer(ptr); *c << writer;
+        SerWriter writer(ptr, store); *c << writer;
 
         // Determine the number of written bytes
         isize count = (isize)(writer.ptr - (buffer + result));
 
         // Check integrity
-        if (count != c->size(false) || force::SNAP_CORRUPTED) {
+        if (count != c->size(false, store) || force::SNAP_CORRUPTED) {
 
-            logcritical("Saved %ld bytes (expected %ld)\n", count, c->size(false));
+            logcritical("Saved %ld bytes (expected %ld)\n", count, c->size(false, store));
             if constexpr (debug::SNP_DEBUG) { fatalError; }
 
             throw MediaError(MediaError::SNAP_CORRUPTED);
         }
 
-        loginfo(NULLDEV, "Saved %ld bytes (expected %ld)\n", count, c->size(false));
+        loginfo(NULLDEV, "Saved %ld bytes (expected %ld)\n", count, c->size(false, store));
         result += count;
     });
 
@@ -174,7 +174,7 @@ private:
 public:
 
     // Returns the size of the internal state in bytes
-    isize size(bool recursive = true);
+    isize size(bool recursive = true, MediaStore *store = nullptr);
 
     // Resets the internal state
     void reset(bool hard);
@@ -185,12 +185,14 @@ public:
     void hardReset() { reset(true); }
     void softReset() { reset(false); }
 
-    // Loads the internal state from a memory buffer
-    isize load(const u8 *buf);
+    // Loads the internal state from a memory buffer (media data may be
+    // resolved via a media store)
+    isize load(const u8 *buf, MediaStore *store = nullptr);
     virtual void _didLoad() { }
 
-    // Saves the internal state to a memory buffer
-    isize save(u8 *buf);
+    // Saves the internal state to a memory buffer (media data may be
+    // referenced via a media store)
+    isize save(u8 *buf, MediaStore *store = nullptr);
     virtual void _didSave() { }
 
 
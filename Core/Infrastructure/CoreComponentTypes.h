@@ -48,6 +48,7 @@ enum class Class : long
     RetroShell,
     Sequencer,
     StateMachine,
+    StreamExporter,
     RTC,
     TOD,
     UART,
@@ -32,11 +32,11 @@ Defaults::fallbacks()
         defaults.values[key] = value;
     };
     */
-    auto registerDefault = [&](Opt option, u64 value) {
+    auto registerDefault = [&](Opt option, i64 value) {
         defaults.values[OptEnum::fullKey(option)] = std::to_string(value);
     };
 
-    auto registerDefaults = [&](Opt option, u64 value, std::vector <isize> objids) {
+    auto registerDefaults = [&](Opt option, i64 value, std::vector <isize> objids) {
         auto key = string(OptEnum::fullKey(option));
         for (auto &nr : objids)
             defaults.values[key + std::to_string(nr)] = std::to_string(value);
@@ -51,10 +51,17 @@ Defaults::fallbacks()
     registerDefault(Opt::AMIGA_WARP_BOOT,            0);
     registerDefault(Opt::AMIGA_WARP_MODE,            (i64)Warp::NEVER);
     registerDefault(Opt::AMIGA_VSYNC,                false);
+    registerDefault(Opt::AMIGA_PACING,               (i64)Pacing::PULSE);
+    registerDefault(Opt::AMIGA_SPIN_TIME,            1000);
+    registerDefault(Opt::AMIGA_CPU_CORE,             -1);
+    registerDefault(Opt::AMIGA_RT_PRIORITY,          false);
     registerDefault(Opt::AMIGA_SPEED_BOOST,          100);
     registerDefault(Opt::AMIGA_RUN_AHEAD,            0);
+    registerDefault(Opt::AMIGA_SPECULATION,          0);
 
     registerDefault(Opt::AMIGA_WS_COMPRESSION,       true);
+    registerDefault(Opt::AMIGA_SNAP_MEDIA_STORE,     false);
+    registerDefault(Opt::AMIGA_BOOT_CACHE,           false);
 
     registerDefault(Opt::AGNUS_REVISION,             (i64)AgnusRevision::ECS_1MB);
     registerDefault(Opt::AGNUS_PTR_DROPS,            true);
@@ -123,6 +130,11 @@ Defaults::fallbacks()
 
     registerDefault(Opt::VID_WHITE_NOISE,            true);
 
+    registerDefault(Opt::EXP_ENABLE,                 false);
+    registerDefault(Opt::EXP_FRAME_SLOTS,            4);
+
+    registerDefault(Opt::REC_QUEUE_SIZE,             32);
+
     registerDefault(Opt::CPU_REVISION,               (i64)CPURev::CPU_68000);
     registerDefault(Opt::CPU_DASM_REVISION,          (i64)CPURev::CPU_68000);
     registerDefault(Opt::CPU_DASM_SYNTAX,            (i64)DasmSyntax::MOIRA);
@@ -238,6 +250,11 @@ Defaults::fallbacks()
     registerDefaults(Opt::SRV_PROTOCOL,               (i64)ServerProtocol::DEFAULT, { (i64)ServerType::SER });
     registerDefaults(Opt::SRV_VERBOSE,                true,                   { (i64)ServerType::SER });
 
+    registerDefaults(Opt::SRV_ENABLE,                 false,                  { (i64)ServerType::FRAME });
+    registerDefaults(Opt::SRV_PORT,                   8086,                   { (i64)ServerType::FRAME });
+    registerDefaults(Opt::SRV_PROTOCOL,               (i64)ServerProtocol::DEFAULT, { (i64)ServerType::FRAME });
+    registerDefaults(Opt::SRV_VERBOSE,                true,                   { (i64)ServerType::FRAME });
+
     defaults.values["ROM_PATH"] = "";
     defaults.values["EXT_PATH"] = "";
     defaults.values["HD0_PATH"] = "";
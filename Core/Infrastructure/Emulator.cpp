@@ -42,6 +42,24 @@ Emulator::~Emulator()
 
 void
 Emulator::launch(const void *listener, Callback *func)
+{
+    prepareLaunch(listener, func);
+
+    // Launch the emulator thread
+    Thread::launch();
+}
+
+void
+Emulator::launch(const void *listener, Callback *func, Farm &farm, isize hint)
+{
+    prepareLaunch(listener, func);
+
+    // Let the farm drive the run loop
+    farm.add(*this, hint);
+}
+
+void
+Emulator::prepareLaunch(const void *listener, Callback *func)
 {
     if (force::LAUNCH_ERROR) throw CoreError(CoreError::LAUNCH);
 
@@ -50,9 +68,6 @@ Emulator::launch(const void *listener, Callback *func)
 
     // Disable the message queue of the run-ahead instance
     ahead.msgQueue.disable();
-
-    // Launch the emulator thread
-    Thread::launch();
 }
 
 void
@@ -128,6 +143,15 @@ Emulator::_dump(Category category, std::ostream &os) const
         os << dec(rua.frame) << std::endl;
         os << tab("Beam");
         os << " (" << dec(rua.v) << "," << dec(rua.h) << ")" << std::endl;
+
+        os << std::endl << "Speculation:" << std::endl << std::endl;
+
+        os << tab("Instances");
+        os << dec(isize(speculations.size())) << std::endl;
+        os << tab("Hits");
+        os << dec(hits) << std::endl;
+        os << tab("Misses");
+        os << dec(misses) << std::endl;
     }
     
     if (category == Category::State) {
@@ -145,6 +169,29 @@ Emulator::_dump(Category category, std::ostream &os) const
         os << tab("Tracking");
         os << bol(isTracking()) << std::endl;
         os << std::endl;
+
+        auto timing = [&](const char *name, const Histogram &h) {
+
+            os << tab(name);
+            os << dec(h.quantile(0.5).asMicroseconds()) << " / ";
+            os << dec(h.quantile(0.99).asMicroseconds()) << " / ";
+            os << dec(h.getMax().asMicroseconds()) << " usec (p50 / p99 / max)" << std::endl;
+        };
+
+        timing("Compute time", computeTime);
+        timing("Overshoot", overshoot);
+        timing("Wakeup latency", wakeupLatency);
+        timing("Deadline misses", deadlineMiss);
+        timing("Texture lock wait", lockWait);
+        os << tab("Missed deadlines");
+        os << dec(deadlineMiss.count()) << " of " << dec(computeTime.count()) << " frames" << std::endl;
+        os << std::endl;
+
+        for (isize i = 0; i <= ResyncEnum::maxVal; i++) {
+
+            os << tab("Resyncs (" + string(ResyncEnum::key(Resync(i))) + ")");
+            os << dec(resyncCount[i]) << std::endl;
+        }
     }
 }
 
@@ -172,6 +219,7 @@ Emulator::cacheMetrics() const
     stats.cpuLoad = cpuLoad;
     stats.fps     = fps;
     stats.resyncs = resyncs;
+    for (isize i = 0; i <= ResyncEnum::maxVal; i++) stats.resyncCount[i] = resyncCount[i];
     stats.clones  = clones;
 
     return stats;
@@ -234,11 +282,24 @@ Emulator::update()
     // Switch warp mode on or off
     shouldWarp() ? warpOn() : warpOff();
 
-    // Mark the run-ahead instance dirty when the command queue has entries
-    isDirty |= !cmdQueue.empty;
+    // Apply the requested scheduling parameters (ignored in farm mode)
+    setScheduling(main.getConfig().cpuCore, main.getConfig().rtPriority);
 
     // Process all commands
-    main.update(cmdQueue);
+    if (speculations.empty()) {
+
+        // Mark the run-ahead instance dirty when the command queue has entries
+        isDirty |= !cmdQueue.empty;
+
+        main.update(cmdQueue);
+
+    } else {
+
+        // Check if the incoming commands have been predicted
+        checkSpeculations();
+
+        main.update(inputQueue);
+    }
 }
 
 bool
@@ -280,23 +341,67 @@ Emulator::missingFrames() const
     return isize(target - frameCounter);
 }
 
+utl::Time
+Emulator::dueTime() const
+{
+    auto &config = main.getConfig();
+
+    // In VSYNC mode, frames are triggered by the host
+    if (config.vsync) return utl::Time(0);
+
+    // Compute when the next frame should be started (rounded up to match missingFrames())
+    auto rate = i64(main.refreshRate());
+    return baseTime + utl::Time(((frameCounter + 1) * 1000000000 + rate - 1) / rate);
+}
+
+utl::Time
+Emulator::frameTime() const
+{
+    return utl::Time(1000000000 / i64(main.refreshRate()));
+}
+
+optional<utl::Time>
+Emulator::spinTime() const
+{
+    auto &config = main.getConfig();
+
+    // Hybrid pacing requires a time-based frame rate
+    if (config.pacing != Pacing::HYBRID || config.vsync) return { };
+
+    return utl::Time::microseconds(config.spinTime);
+}
+
 void
 Emulator::computeFrame()
 {
+    utl::TraceSpan trace("emulator", "computeFrame");
+
     auto &config = main.getConfig();
 
+    // Create or delete speculative instances if the configuration has changed
+    auto count = config.runAhead > 0 ? config.speculation : 0;
+    if (count != isize(speculations.size())) setupSpeculations(count);
+
     if (config.runAhead > 0) {
 
         try {
 
-            // Run the main instance
-            main.computeFrame();
+            if (count) {
+
+                // Run both instances in parallel
+                computeFrameInParallel();
+
+            } else {
 
-            // Recreate the run-ahead instance if necessary
-            if (isDirty || debug::RUA_ON_STEROIDS) recreateRunAheadInstance();
+                // Run the main instance
+                main.computeFrame();
 
-            // Run the runahead instance
-            ahead.computeFrame();
+                // Recreate the run-ahead instance if necessary
+                if (isDirty || debug::RUA_ON_STEROIDS) recreateRunAheadInstance();
+
+                // Run the runahead instance
+                ahead.computeFrame();
+            }
 
         } catch (StateChangeException &) {
 
@@ -340,25 +445,232 @@ Emulator::recreateRunAheadInstance()
 {
     assert(main.config.runAhead > 0);
 
+    utl::TraceSpan trace("runahead", "recreateRunAheadInstance");
+
     auto &config = main.getConfig();
 
     // Clone the main instance
-    if constexpr (debug::RUA_DEBUG) {
-        utl::StopWatch watch("Run-ahead: Clone");
-        cloneRunAheadInstance();
-    } else {
-        cloneRunAheadInstance();
+    {   utl::TraceSpan trace("runahead", "clone");
+
+        if constexpr (debug::RUA_DEBUG) {
+            utl::StopWatch watch("Run-ahead: Clone");
+            cloneRunAheadInstance();
+        } else {
+            cloneRunAheadInstance();
+        }
     }
 
     // Advance to the proper frame
-    if constexpr (debug::RUA_DEBUG) {
-        utl::StopWatch watch("Run-ahead: Fast-forward");
-        ahead.fastForward(config.runAhead - 1);
+    {   utl::TraceSpan trace("runahead", "fastForward");
+
+        if constexpr (debug::RUA_DEBUG) {
+            utl::StopWatch watch("Run-ahead: Fast-forward");
+            ahead.fastForward(config.runAhead - 1);
+        } else {
+            ahead.fastForward(config.runAhead - 1);
+        }
+    }
+}
+
+void
+Emulator::computeFrameInParallel()
+{
+    auto &config = main.getConfig();
+
+    // Take over a speculative instance if it has predicted the latest input
+    if (isDirty && match) adoptSpeculation(*match);
+    match = nullptr;
+
+    // Speculate on the input of the next frame (pointless in warp mode)
+    startSpeculations(isWarping() ? 0 : config.runAhead);
+    inputs.clear();
+
+    if (isDirty || debug::RUA_ON_STEROIDS) {
+
+        misses++;
+
+        // Recreate the run-ahead instance serially
+        main.computeFrame();
+        recreateRunAheadInstance();
+        ahead.computeFrame();
+
     } else {
-        ahead.fastForward(config.runAhead - 1);
+
+        // Run the run-ahead instance on the helper thread
+        aheadWorker->submit([this]() { ahead.computeFrame(); });
+
+        try {
+
+            // Run the main instance on this thread
+            main.computeFrame();
+
+        } catch (...) {
+
+            // Don't leave before the helper thread is done with the instance
+            aheadWorker->wait();
+            throw;
+        }
+        aheadWorker->wait();
+    }
+}
+
+void
+Emulator::setupSpeculations(isize count)
+{
+    loginfo(RUA_DEBUG, "Setting up %ld speculative instances\n", count);
+
+    // Wait until all helper threads are idle
+    for (auto &spec : speculations) try { spec.worker->wait(); } catch (...) { }
+
+    // Create the helper thread for the run-ahead instance
+    if (count && !aheadWorker) aheadWorker = std::make_unique<utl::Worker>("Run-ahead");
+    if (!count) aheadWorker = nullptr;
+
+    speculations.resize(count);
+    match = nullptr;
+
+    for (isize i = 0; i < count; i++) {
+
+        auto &spec = speculations[i];
+
+        if (!spec.worker) {
+
+            spec.base = std::make_unique<Amiga>(*this, 1);
+            spec.amiga = std::make_unique<Amiga>(*this, 1);
+            spec.base->initialize();
+            spec.amiga->initialize();
+            spec.base->msgQueue.disable();
+            spec.amiga->msgQueue.disable();
+            spec.worker = std::make_unique<utl::Worker>("Speculation " + std::to_string(i));
+        }
+        spec.frame = -1;
+        spec.synced = false;
+    }
+}
+
+void
+Emulator::checkSpeculations()
+{
+    auto predictable = [](const Command &cmd) {
+        return cmd.type == Cmd::JOY_EVENT || cmd.type == Cmd::MOUSE_BUTTON;
+    };
+    auto equal = [](const Command &c1, const Command &c2) {
+        return c1.type == c2.type && c1.action.port == c2.action.port && c1.action.action == c2.action.action;
+    };
+    auto desync = [&]() {
+        for (auto &spec : speculations) spec.synced = false;
+    };
+
+    // The base instances can't follow if the main instance has been altered
+    // or if the events of the previous update haven't been replayed yet
+    if (isDirty || !inputs.empty()) desync();
+
+    // Forward all pending commands to the main instance
+    inputs.clear();
+    match = nullptr;
+
+    for (Command cmd; cmdQueue.poll(cmd); ) {
+
+        inputQueue.put(cmd);
+        inputs.push_back(cmd);
+
+        // Only input events can be replayed by the base instances
+        if (!Amiga::isInput(cmd)) desync();
+
+        if (predictable(cmd)) {
+
+            // Move the event to the front of the history
+            std::erase_if(recentInputs, [&](const Command &c) { return equal(c, cmd); });
+            recentInputs.insert(recentInputs.begin(), cmd);
+            if (recentInputs.size() > speculations.size() + 1) recentInputs.pop_back();
+        }
+    }
+
+    // Look for a speculation that has predicted the received event
+    if (!isDirty && inputs.size() == 1) {
+
+        for (auto &spec : speculations) {
+
+            if (spec.frame == main.agnus.pos.frame && equal(spec.input, inputs[0])) match = &spec;
+        }
+    }
+
+    // Mark the run-ahead instance dirty when commands have been received
+    isDirty |= !inputs.empty();
+}
+
+void
+Emulator::startSpeculations(isize frames)
+{
+    bool resynced = false;
+
+    for (isize i = 0; i < isize(speculations.size()); i++) {
+
+        auto &spec = speculations[i];
+        spec.frame = -1;
+
+        // The base instance falls behind if the helper thread is still busy
+        if (!frames || spec.worker->isBusy()) { spec.synced = false; continue; }
+
+        // The base instance is out of sync if the previous frame was interrupted
+        try { spec.worker->wait(); } catch (...) { spec.synced = false; }
+
+        // Input events to be replayed by the base instance
+        auto replay = inputs;
+
+        if (!spec.synced) {
+
+            // Resynchronize a single base instance per frame
+            if (resynced) continue;
+
+            *spec.base = main;
+            spec.synced = resynced = true;
+            replay.clear();
+        }
+
+        // Predict one of the recent events that differ from the latest one
+        auto predict = i + 1 < isize(recentInputs.size());
+
+        if (predict) {
+
+            spec.input = recentInputs[i + 1];
+            spec.frame = main.agnus.pos.frame + 1;
+        }
+
+        spec.worker->submit([&spec, replay, predict, frames]() {
+
+            utl::TraceSpan trace("runahead", "speculate");
+
+            // Mirror the frame computed by the main instance
+            for (auto &cmd : replay) spec.base->processInput(cmd);
+            spec.base->computeFrame();
+
+            if (predict) {
+
+                // Fork the base instance and apply the predicted event
+                *spec.amiga = *spec.base;
+                spec.amiga->processInput(spec.input);
+                spec.amiga->fastForward(frames);
+            }
+        });
     }
 }
 
+bool
+Emulator::adoptSpeculation(Speculation &spec)
+{
+    // Wait for the speculation to complete
+    try { spec.worker->wait(); } catch (...) { spec.synced = false; return false; }
+
+    utl::TraceSpan trace("runahead", "adopt");
+
+    ahead = *spec.amiga;
+    isDirty = false;
+    hits++;
+
+    return true;
+}
+
 void
 Emulator::hardReset()
 {
@@ -403,6 +715,17 @@ Emulator::finishFrame()
     run();
 }
 
+void
+Emulator::lockTexture()
+{
+    // Only measure the waiting time if the lock is contended
+    if (textureLock.tryLock()) { lockWait.record(utl::Time(0)); return; }
+
+    auto start = utl::Time::now();
+    textureLock.lock();
+    lockWait.record(utl::Time::now() - start);
+}
+
 const Texture &
 Emulator::getTexture() const
 {
@@ -14,6 +14,7 @@
 #include "Amiga.h"
 #include "Host.h"
 #include "Thread.h"
+#include "Farm.h"
 #include "CmdQueue.h"
 
 namespace vamiga {
@@ -46,12 +47,61 @@ private:
     // Indicates if the run-ahead instance needs to be updated
     bool isDirty = true;
 
+    /* A speculative run-ahead instance. The base instance mirrors the main
+     * instance on a helper thread by computing the same frames and replaying
+     * the same input events. After each frame, the base instance is forked,
+     * the predicted input event is applied, and the fork is advanced to the
+     * frame the run-ahead instance would be in.
+     */
+    struct Speculation {
+
+        std::unique_ptr<Amiga> base;
+        std::unique_ptr<Amiga> amiga;
+        std::unique_ptr<utl::Worker> worker;
+
+        // The predicted input event
+        Command input;
+
+        // Frame of the main instance the prediction applies to (-1 = none)
+        i64 frame = -1;
+
+        // Indicates if the base instance is in sync with the main instance
+        bool synced = false;
+    };
+
+    // Helper thread computing the run-ahead instance in parallel
+    std::unique_ptr<utl::Worker> aheadWorker;
+
+    // Speculative run-ahead instances
+    std::vector<Speculation> speculations;
+
+    // The speculation predicting the latest input (if any)
+    Speculation *match = nullptr;
+
+    // Input events received in the current frame
+    std::vector<Command> inputs;
+
+    // Recently received joystick and mouse button events (most recent first)
+    std::vector<Command> recentInputs;
+
+    // Speculation statistics
+    isize hits = 0;
+    isize misses = 0;
+
     // Incoming external events
     CmdQueue cmdQueue;
 
+    // Commands forwarded to the main instance while speculating
+    CmdQueue inputQueue;
+
     // Texture lock
     utl::Mutex textureLock;
 
+public:
+
+    // Time spent waiting for the texture lock
+    utl::Histogram lockWait;
+
 
     //
     // Methods
@@ -65,6 +115,16 @@ public:
     // Launches the emulator thread
     void launch(const void *listener, Callback *func);
 
+    // Hands the emulator over to a farm instead of launching a thread
+    void launch(const void *listener, Callback *func, Farm &farm, isize hint = -1);
+
+private:
+
+    // Connects the listener and prepares both instances for launching
+    void prepareLaunch(const void *listener, Callback *func);
+
+public:
+
     // Initializes all components
     void initialize() override;
 
@@ -130,6 +190,9 @@ private:
     void update() override;
     bool shouldWarp() const;
     isize missingFrames() const override;
+    utl::Time dueTime() const override;
+    utl::Time frameTime() const override;
+    optional<utl::Time> spinTime() const override;
     void computeFrame() override;
 
     void _powerOn() override { main.powerOn(); }
@@ -157,6 +220,21 @@ private:
     // Clones the run-ahead instance and fast forwards it to the proper frame
     void recreateRunAheadInstance();
 
+    // Computes the main and the run-ahead instance on separate threads
+    void computeFrameInParallel();
+
+    // Adjusts the number of speculative instances
+    void setupSpeculations(isize count);
+
+    // Records the pending commands and looks for a matching speculation
+    void checkSpeculations();
+
+    // Starts a speculation for each recently received input event
+    void startSpeculations(isize frames);
+
+    // Replaces the run-ahead instance by a speculative instance
+    bool adoptSpeculation(Speculation &spec);
+
 
     //
     // Execution control
@@ -176,7 +254,7 @@ public:
     //
 
     const Texture &getTexture() const;
-    void lockTexture() { textureLock.lock(); }
+    void lockTexture();
     void unlockTexture() { textureLock.unlock(); }
 
 
@@ -37,6 +37,7 @@ typedef struct
     double cpuLoad;         ///< Measured CPU load
     double fps;             ///< Measured frames per seconds
     isize resyncs;          ///< Number of out-of-sync conditions
+    isize resyncCount[ResyncEnum::maxVal + 1]; ///< Number of out-of-sync conditions per cause
     isize clones;           ///< Number of created run-ahead instances
 }
 EmulatorMetrics;
@@ -0,0 +1,179 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the Mozilla Public License v2
+//
+// See https://mozilla.org/MPL/2.0 for license information
+// -----------------------------------------------------------------------------
+
+#include "config.h"
+#include "Farm.h"
+#include "Thread.h"
+#include "utl/chrono.h"
+#include "utl/io.h"
+
+namespace vamiga {
+
+Farm::Farm(isize numWorkers)
+{
+    assert(numWorkers > 0);
+
+    for (isize i = 0; i < numWorkers; i++) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (isize i = 0; i < numWorkers; i++) {
+        workers[i]->thread = std::thread(&Farm::workerMain, this, i);
+    }
+}
+
+Farm::~Farm()
+{
+    if (instances) loginfo(RUN_DEBUG, "Destroying a farm with %ld active instances\n", isize(instances));
+
+    {   std::lock_guard<std::mutex> guard(idleMutex);
+        stopping = true;
+    }
+    idleCond.notify_all();
+
+    for (auto &worker : workers) worker->thread.join();
+}
+
+void
+Farm::_dump(Category category, std::ostream &os) const
+{
+    using namespace utl;
+
+    if (category == Category::State) {
+
+        os << tab("Workers");
+        os << dec(numWorkers()) << std::endl;
+        os << tab("Instances");
+        os << dec(numInstances()) << std::endl;
+
+        for (isize i = 0; i < numWorkers(); i++) {
+
+            auto &w = *workers[i];
+            os << tab("Worker " + std::to_string(i));
+            os << dec(w.quanta) << " quanta, " << dec(w.frames) << " frames, ";
+            os << dec(w.steals) << " steals" << std::endl;
+        }
+    }
+}
+
+void
+Farm::add(Thread &thread, isize hint)
+{
+    // Initialize the instance on the calling thread
+    thread.host(*this);
+    instances++;
+
+    // Assign it to a worker
+    auto nr = (hint >= 0 ? hint : next++) % numWorkers();
+
+    {   std::lock_guard<std::mutex> guard(workers[nr]->mutex);
+        workers[nr]->queue.push_back(&thread);
+    }
+    {   std::lock_guard<std::mutex> guard(idleMutex); }
+    idleCond.notify_all();
+}
+
+void
+Farm::join(const Thread &thread)
+{
+    std::unique_lock<std::mutex> lock(retiredMutex);
+
+    retiredCond.wait(lock, [&]() { return thread.retired; });
+}
+
+Thread *
+Farm::pick(isize nr)
+{
+    // Serve the own queue in round-robin order
+    {   auto &w = *workers[nr];
+        std::lock_guard<std::mutex> guard(w.mutex);
+
+        if (!w.queue.empty()) {
+
+            auto *result = w.queue.front();
+            w.queue.pop_front();
+            return result;
+        }
+    }
+
+    // Steal an instance from another worker
+    for (isize i = 1; i < numWorkers(); i++) {
+
+        auto &w = *workers[(nr + i) % numWorkers()];
+        std::lock_guard<std::mutex> guard(w.mutex);
+
+        if (!w.queue.empty()) {
+
+            auto *result = w.queue.back();
+            w.queue.pop_back();
+            workers[nr]->steals++;
+            return result;
+        }
+    }
+
+    return nullptr;
+}
+
+void
+Farm::workerMain(isize nr)
+{
+    utl::Tracer::setThreadName("Farm worker " + std::to_string(nr));
+
+    auto &w = *workers[nr];
+    isize idle = 0;
+
+    while (true) {
+
+        auto *thread = pick(nr);
+
+        if (!thread) {
+
+            // Wait for new work
+            std::unique_lock<std::mutex> lock(idleMutex);
+            if (stopping) break;
+            idleCond.wait_for(lock, std::chrono::milliseconds(10));
+            continue;
+        }
+
+        // Run a single quantum
+        auto frames = thread->step();
+        w.quanta++;
+
+        // Retire the instance if it has terminated
+        if (frames < 0) {
+
+            {   std::lock_guard<std::mutex> guard(retiredMutex);
+                thread->retired = true;
+                instances--;
+            }
+            retiredCond.notify_all();
+            continue;
+        }
+
+        w.frames += frames;
+
+        // Put the instance back into the own queue
+        isize size;
+        {   std::lock_guard<std::mutex> guard(w.mutex);
+            w.queue.push_back(thread);
+            size = isize(w.queue.size());
+        }
+
+        // Back off if no instance of this worker was due for a frame
+        if (frames) {
+            idle = 0;
+        } else if (++idle >= size) {
+            idle = 0;
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+
+        if (stopping) break;
+    }
+}
+
+}
@@ -0,0 +1,106 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the Mozilla Public License v2
+//
+// See https://mozilla.org/MPL/2.0 for license information
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "CoreObject.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace vamiga {
+
+class Thread;
+
+/** Drives multiple emulator instances on a shared pool of worker threads.
+ *  Instead of launching a thread per instance, each instance is handed over
+ *  to the farm, which executes it in quanta of a single run-loop iteration
+ *  (one frame in warp mode). Each worker serves its own queue in round-robin
+ *  order, which gives all instances of a worker an equal share of CPU time.
+ *  A worker whose queue runs empty steals instances from the back of the
+ *  other queues. An affinity hint selects the worker an instance starts on.
+ *
+ *  Instances must be halted before the farm is destroyed.
+ */
+class Farm final : public CoreObject {
+
+    struct Worker {
+
+        std::thread thread;
+        std::mutex mutex;
+        std::deque<Thread *> queue;
+
+        // Statistics
+        std::atomic<i64> quanta = 0;
+        std::atomic<i64> frames = 0;
+        std::atomic<i64> steals = 0;
+    };
+
+    // The worker pool
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // Number of hosted instances that have not terminated yet
+    std::atomic<isize> instances = 0;
+
+    // Worker assigned to the next instance without an affinity hint
+    std::atomic<isize> next = 0;
+
+    // Used to park workers while there is nothing to do
+    std::mutex idleMutex;
+    std::condition_variable idleCond;
+    std::atomic<bool> stopping = false;
+
+    // Signals the termination of an instance (see Thread::retired)
+    std::mutex retiredMutex;
+    std::condition_variable retiredCond;
+
+
+    //
+    // Initializing
+    //
+
+public:
+
+    Farm(isize numWorkers);
+    ~Farm();
+
+    const char *objectName() const override { return "Farm"; }
+
+    isize numWorkers() const { return isize(workers.size()); }
+    isize numInstances() const { return instances; }
+
+private:
+
+    void _dump(Category category, std::ostream &os) const override;
+
+
+    //
+    // Scheduling
+    //
+
+public:
+
+    // Hands over an instance (hint = preferred worker, -1 = none)
+    void add(Thread &thread, isize hint = -1);
+
+    // Waits until an instance has terminated (may be called repeatedly)
+    void join(const Thread &thread);
+
+private:
+
+    // Main function of a worker thread
+    void workerMain(isize nr);
+
+    // Picks the next instance (own queue first, then other queues)
+    Thread *pick(isize nr);
+};
+
+}
@@ -253,6 +253,25 @@ Host::makeAbsolute(const fs::path &path) const
     return path.is_absolute() ? path : searchPath / path;
 }
 
+void
+Host::setMediaPath(const fs::path &path)
+{
+    SYNCHRONIZED
+
+    mediaPath = path;
+}
+
+fs::path
+Host::getMediaPath() const
+{
+    {   SYNCHRONIZED
+
+        if (!mediaPath.empty()) return mediaPath;
+    }
+
+    return tmp("vAmiga.media");
+}
+
 fs::path
 Host::tmp() const
 {
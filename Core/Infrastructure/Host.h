@@ -40,6 +40,9 @@ class Host final : public SubComponent {
 
     // Search path prepended in makeAbsolute()
     fs::path searchPath;
+
+    // Location of the media store (defaults to a temporary folder if empty)
+    fs::path mediaPath;
     
     
     //
@@ -111,6 +114,10 @@ public:
     // Makes a path absolute
     fs::path makeAbsolute(const fs::path &path) const;
 
+    // Sets or returns the location of the media store
+    void setMediaPath(const fs::path &path);
+    fs::path getMediaPath() const;
+
     // Returns a path to a temporary folder
     fs::path tmp() const;
 
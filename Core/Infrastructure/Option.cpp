@@ -34,9 +34,16 @@ OptionParser::create(Opt opt, i64 arg)
         case Opt::AMIGA_WARP_MODE:           return enumParser.template operator()<WarpEnum,Warp>();
         case Opt::AMIGA_WARP_BOOT:           return numParser(" sec");
         case Opt::AMIGA_VSYNC:               return boolParser();
+        case Opt::AMIGA_PACING:              return enumParser.template operator()<PacingEnum,Pacing>();
+        case Opt::AMIGA_SPIN_TIME:           return numParser(" usec");
+        case Opt::AMIGA_CPU_CORE:            return numParser();
+        case Opt::AMIGA_RT_PRIORITY:         return boolParser();
         case Opt::AMIGA_SPEED_BOOST:         return numParser("%");
         case Opt::AMIGA_RUN_AHEAD:           return numParser(" frames");
+        case Opt::AMIGA_SPECULATION:         return numParser(" instances");
         case Opt::AMIGA_WS_COMPRESSION:      return boolParser();
+        case Opt::AMIGA_SNAP_MEDIA_STORE:    return boolParser();
+        case Opt::AMIGA_BOOT_CACHE:          return boolParser();
 
         case Opt::AGNUS_REVISION:            return enumParser.template operator()<AgnusRevisionEnum,AgnusRevision>();
         case Opt::AGNUS_PTR_DROPS:           return boolParser();
@@ -111,6 +118,11 @@ OptionParser::create(Opt opt, i64 arg)
         case Opt::LA_ADDR3:                  return hexParser();
 
         case Opt::VID_WHITE_NOISE:           return boolParser();
+
+        case Opt::EXP_ENABLE:                return boolParser();
+        case Opt::EXP_FRAME_SLOTS:           return numParser();
+
+        case Opt::REC_QUEUE_SIZE:            return numParser(" frames");
             
         case Opt::CPU_REVISION:              return enumParser.template operator()<CPURevEnum,CPURev>();
         case Opt::CPU_DASM_REVISION:         return enumParser.template operator()<DasmRevEnum,DasmRev>();
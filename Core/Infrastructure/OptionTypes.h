@@ -30,12 +30,21 @@ enum class Opt : long
     AMIGA_WARP_BOOT,        ///< Warp-boot time in seconds
     AMIGA_WARP_MODE,        ///< Warp activation mode
     AMIGA_VSYNC,            ///< Derive the frame rate to the VSYNC signal
+    AMIGA_PACING,           ///< Frame pacing method
+    AMIGA_SPIN_TIME,        ///< Busy-wait time before a frame is due
+    AMIGA_CPU_CORE,         ///< CPU core the emulator thread is pinned to
+    AMIGA_RT_PRIORITY,      ///< Request real-time scheduling
     AMIGA_SPEED_BOOST,      ///< Speed adjustment in percent
     AMIGA_RUN_AHEAD,        ///< Number of run-ahead frames
+    AMIGA_SPECULATION,      ///< Number of speculative run-ahead instances
 
     // Workspaces
     AMIGA_WS_COMPRESSION,   ///< Workspace media file compression
 
+    // Snapshots
+    AMIGA_SNAP_MEDIA_STORE, ///< Store disk and Rom data in the media store
+    AMIGA_BOOT_CACHE,       ///< Restore cached boot states on power-on
+
     // Agnus
     AGNUS_REVISION,
     AGNUS_PTR_DROPS,
@@ -116,6 +125,13 @@ enum class Opt : long
     // Video port
     VID_WHITE_NOISE,        ///< Generate white-noise when switched off
 
+    // Stream exporter
+    EXP_ENABLE,             ///< Publish frames and audio in shared memory
+    EXP_FRAME_SLOTS,        ///< Number of frames kept in shared memory
+
+    // Recorder
+    REC_QUEUE_SIZE,         ///< Number of frames waiting to be written
+
     // CPU
     CPU_REVISION,
     CPU_DASM_REVISION,
@@ -240,9 +256,16 @@ struct OptEnum : Reflectable<OptEnum, Opt>
             case Opt::AMIGA_WARP_BOOT:           return "AMIGA.WARP_BOOT";
             case Opt::AMIGA_WARP_MODE:           return "AMIGA.WARP_MODE";
             case Opt::AMIGA_VSYNC:               return "AMIGA.VSYNC";
+            case Opt::AMIGA_PACING:              return "AMIGA.PACING";
+            case Opt::AMIGA_SPIN_TIME:           return "AMIGA.SPIN_TIME";
+            case Opt::AMIGA_CPU_CORE:            return "AMIGA.CPU_CORE";
+            case Opt::AMIGA_RT_PRIORITY:         return "AMIGA.RT_PRIORITY";
             case Opt::AMIGA_SPEED_BOOST:         return "AMIGA.SPEED_BOOST";
             case Opt::AMIGA_RUN_AHEAD:           return "AMIGA.RUN_AHEAD";
+            case Opt::AMIGA_SPECULATION:         return "AMIGA.SPECULATION";
             case Opt::AMIGA_WS_COMPRESSION:      return "AMIGA.WS_COMPRESSION";
+            case Opt::AMIGA_SNAP_MEDIA_STORE:    return "AMIGA.SNAP_MEDIA_STORE";
+            case Opt::AMIGA_BOOT_CACHE:          return "AMIGA.BOOT_CACHE";
                 
             case Opt::AGNUS_REVISION:            return "AGNUS.REVISION";
             case Opt::AGNUS_PTR_DROPS:           return "AGNUS.PTR_DROPS";
@@ -317,6 +340,11 @@ struct OptEnum : Reflectable<OptEnum, Opt>
             case Opt::LA_ADDR3:                  return "LA.ADDR3";
                 
             case Opt::VID_WHITE_NOISE:           return "VID.WHITE_NOISE";
+
+            case Opt::EXP_ENABLE:                return "EXP.ENABLE";
+            case Opt::EXP_FRAME_SLOTS:           return "EXP.FRAME_SLOTS";
+
+            case Opt::REC_QUEUE_SIZE:            return "REC.QUEUE_SIZE";
                 
             case Opt::CPU_REVISION:              return "CPU.REVISION";
             case Opt::CPU_DASM_REVISION:         return "CPU.DASM_REVISION";
@@ -422,9 +450,16 @@ struct OptEnum : Reflectable<OptEnum, Opt>
             case Opt::AMIGA_WARP_BOOT:           return "Warp-boot duration";
             case Opt::AMIGA_WARP_MODE:           return "Warp activation";
             case Opt::AMIGA_VSYNC:               return "VSYNC mode";
+            case Opt::AMIGA_PACING:              return "Frame pacing";
+            case Opt::AMIGA_SPIN_TIME:           return "Busy-wait time before a frame is due";
+            case Opt::AMIGA_CPU_CORE:            return "Pin the emulator thread to a CPU core";
+            case Opt::AMIGA_RT_PRIORITY:         return "Real-time scheduling";
             case Opt::AMIGA_SPEED_BOOST:         return "Speed adjustment";
             case Opt::AMIGA_RUN_AHEAD:           return "Run-ahead frames";
+            case Opt::AMIGA_SPECULATION:         return "Speculative run-ahead instances";
             case Opt::AMIGA_WS_COMPRESSION:      return "Compress workspaces";
+            case Opt::AMIGA_SNAP_MEDIA_STORE:    return "Reference media in snapshots";
+            case Opt::AMIGA_BOOT_CACHE:          return "Boot state cache";
 
             case Opt::AGNUS_REVISION:            return "Chip revision";
             case Opt::AGNUS_PTR_DROPS:           return "Ignore certain register writes";
@@ -499,6 +534,11 @@ struct OptEnum : Reflectable<OptEnum, Opt>
             case Opt::LA_ADDR3:                  return "Channel 3 memory address";
                 
             case Opt::VID_WHITE_NOISE:           return "White noise";
+
+            case Opt::EXP_ENABLE:                return "Export to shared memory";
+            case Opt::EXP_FRAME_SLOTS:           return "Number of frame slots";
+
+            case Opt::REC_QUEUE_SIZE:            return "Write queue size";
                 
             case Opt::CPU_REVISION:              return "Chip revision";
             case Opt::CPU_DASM_REVISION:         return "Chip revision (disassembler)";
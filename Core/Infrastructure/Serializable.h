@@ -14,6 +14,7 @@
 #include "utl/abilities/Hashable.h"
 #include "utl/abilities/Streamable.h"
 #include "utl/support/Bits.h"
+#include "MediaStore.h"
 
 #include <concepts>
 
@@ -21,6 +22,13 @@ namespace vamiga {
 
 using utl::Hashable;
 
+/* Wraps a buffer holding disk or Rom data. Workers connected to a media store
+ * serialize the buffer by reference, i.e., they replace the buffer contents by
+ * the keys of the chunks in the store. Otherwise, the buffer is serialized the
+ * same way as a plain buffer.
+ */
+struct MediaRef { utl::Buffer<u8> &buffer; };
+
 /*
 class Serializable {
 
@@ -145,7 +153,10 @@ public:
 
     isize count;
 
-    SerCounter() { count = 0; }
+    // Optional store for disk and Rom data
+    MediaStore *store;
+
+    SerCounter(MediaStore *store = nullptr) : store(store) { count = 0; }
 
     COUNT8(const bool)
     COUNT8(const char)
@@ -169,6 +180,13 @@ public:
         return *this;
     }
 
+    auto& operator<<(const MediaRef &r)
+    {
+        count += 8;
+        media(r.buffer.size);
+        return *this;
+    }
+
     template <class T, isize N>
     auto& operator<<(utl::Array<T, N> &a)
     {
@@ -249,6 +267,12 @@ public:
         v << *this;
         return *this;
     }
+
+    // Counts disk or Rom data stored either by value or by reference
+    void media(isize n)
+    {
+        count += store ? 8 * MediaStore::numChunks(n) : n;
+    }
 };
 
 
@@ -293,6 +317,11 @@ public:
         return *this;
     }
 
+    auto& operator<<(const MediaRef &r)
+    {
+        return *this << r.buffer;
+    }
+
     template <class T, isize N>
     auto& operator<<(utl::Array<T, N> &a)
     {
@@ -400,7 +429,10 @@ public:
 
     const u8 *ptr;
 
-    SerReader(const u8 *p) : ptr(p) { }
+    // Optional store for disk and Rom data
+    MediaStore *store;
+
+    SerReader(const u8 *p, MediaStore *store = nullptr) : ptr(p), store(store) { }
 
     DESERIALIZE8(bool)
     DESERIALIZE8(char)
@@ -427,6 +459,15 @@ public:
         return *this;
     }
 
+    auto& operator<<(const MediaRef &r)
+    {
+        i64 len;
+        *this << len;
+        r.buffer.init(isize(len));
+        media(r.buffer.ptr, isize(len));
+        return *this;
+    }
+
     template <class T, isize N>
     auto& operator<<(utl::Array<T, N> &a)
     {
@@ -522,6 +563,16 @@ public:
         std::memcpy(dst, (void *)ptr, n);
         ptr += n;
     }
+
+    // Reads disk or Rom data either by value or from the media store
+    void media(u8 *dst, isize n)
+    {
+        if (!store) { copy(dst, n); return; }
+
+        for (isize i = 0; i < n; i += MediaStore::chunkSize) {
+            store->get(read64(ptr), dst + i, std::min(n - i, MediaStore::chunkSize));
+        }
+    }
 };
 
 
@@ -547,7 +598,10 @@ public:
 
     u8 *ptr;
 
-    SerWriter(u8 *p) : ptr(p) { }
+    // Optional store for disk and Rom data
+    MediaStore *store;
+
+    SerWriter(u8 *p, MediaStore *store = nullptr) : ptr(p), store(store) { }
 
     SERIALIZE8(const bool)
     SERIALIZE8(const char)
@@ -573,6 +627,13 @@ public:
         return *this;
     }
 
+    auto& operator<<(const MediaRef &r)
+    {
+        *this << i64(r.buffer.size);
+        media(r.buffer.ptr, r.buffer.size);
+        return *this;
+    }
+
     template <class T, isize N>
     auto& operator<<(utl::Array<T, N> &a)
     {
@@ -661,6 +722,16 @@ public:
         std::memcpy((void *)ptr, src, n);
         ptr += n;
     }
+
+    // Writes disk or Rom data either by value or as references into the media store
+    void media(const u8 *src, isize n)
+    {
+        if (!store) { copy(src, n); return; }
+
+        for (isize i = 0; i < n; i += MediaStore::chunkSize) {
+            write64(ptr, store->put(src + i, std::min(n - i, MediaStore::chunkSize)));
+        }
+    }
 };
 
 
@@ -708,6 +779,11 @@ public:
         return *this;
     }
 
+    auto& operator<<(const MediaRef &r)
+    {
+        return *this << r.buffer;
+    }
+
     template <class T, isize N>
     auto& operator<<(utl::Array<T, N> &a)
     {
@@ -51,10 +51,12 @@ osDebugger(ref.osDebugger),
 paula(ref.paula),
 pixelEngine(ref.denise.pixelEngine),
 ramExpansion(ref.ramExpansion),
+recorder(ref.recorder),
 remoteManager(ref.remoteManager),
 retroShell(ref.retroShell),
 rtc(ref.rtc),
 serialPort(ref.serialPort),
+streamExporter(ref.streamExporter),
 uart(ref.paula.uart),
 videoPort(ref.videoPort),
 zorro(ref.zorro)
@@ -53,10 +53,12 @@ public:
     class Paula &paula;
     class PixelEngine &pixelEngine;
     class RamExpansion &ramExpansion;
+    class Recorder &recorder;
     class RemoteManager &remoteManager;
     class RetroShell &retroShell;
     class RTC &rtc;
     class SerialPort &serialPort;
+    class StreamExporter &streamExporter;
     class UART &uart;
     class VideoPort &videoPort;
     class ZorroManager &zorro;
@@ -9,9 +9,15 @@
 
 #include "config.h"
 #include "Thread.h"
+#include "Farm.h"
 #include "utl/chrono.h"
 #include <iostream>
 
+#if defined(__linux__) || defined(__APPLE__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 namespace vamiga {
 
 void
@@ -31,24 +37,87 @@ Thread::launch()
 }
 
 void
-Thread::resync()
+Thread::host(Farm &farm)
+{
+    assert(!isLaunched());
+    assert(!isInitialized());
+
+    this->farm = &farm;
+
+    // Initialize the emulator on the calling thread
+    owner = std::this_thread::get_id();
+    initialize();
+    owner = std::thread::id();
+
+    assert(isInitialized());
+}
+
+isize
+Thread::step()
+{
+    assert(farm);
+
+    // Skip the quantum if the thread is suspended
+    if (!suspensionLock.tryLock()) return 0;
+    suspensionLock.unlock();
+
+    owner = std::this_thread::get_id();
+
+    // Prepare for the next frame
+    update();
+
+    // Compute missing frames
+    auto frames = execute();
+
+    // Compute statistics
+    computeStats();
+
+    owner = std::thread::id();
+
+    // Signal termination (the farm informs threads waiting in join())
+    return state == ExecState::HALTED ? -1 : frames;
+}
+
+void
+Thread::join()
+{
+    if (thread.joinable()) {
+
+        thread.join();
+
+    } else if (farm) {
+
+        farm->join(*this);
+    }
+}
+
+void
+Thread::resync(Resync cause)
 {
     resyncs++;
+    resyncCount[long(cause)]++;
     baseTime = utl::Time::now();
     frameCounter = 0;
 }
 
-void
+isize
 Thread::execute()
 {
     // Only proceed if the emulator is running
-    if (!isRunning()) return;
+    if (!isRunning()) { interrupted = true; return 0; }
 
     // Determine the number of overdue frames
     isize missing = warp ? 1 : missingFrames();
 
     if (std::abs(missing) <= 5) {
 
+        // Measure how late the first overdue frame is computed
+        if (missing > 0 && !warp && !interrupted) {
+
+            if (auto due = dueTime(); due.asNanoseconds()) overshoot.record(utl::Time::now() - due);
+        }
+        interrupted = warp != 0;
+
         lock.lock();
         loadClock.go();
 
@@ -58,7 +127,16 @@ Thread::execute()
             for (isize i = 0; i < missing; i++, frameCounter++) {
                 
                 // Execute a single frame
+                auto due = warp ? utl::Time(0) : dueTime();
+                auto start = utl::Time::now();
                 computeFrame();
+                auto end = utl::Time::now();
+                computeTime.record(end - start);
+
+                // Check if the frame has been completed before the next one is due
+                if (due.asNanoseconds() && end > due + frameTime()) {
+                    deadlineMiss.record(end - due - frameTime());
+                }
             }
             
         } catch (StateChangeException &exc) {
@@ -70,6 +148,8 @@ Thread::execute()
         loadClock.stop();
         lock.unlock();
 
+        return std::max(missing, isize(0));
+
     } else {
 
         // The emulator is out of sync
@@ -79,8 +159,11 @@ Thread::execute()
             loginfo(RUN_DEBUG, "Emulation is way too fast (%ld time slices ahead)\n", -missing);
         }
 
-        resync();
+        resync(interrupted ? Resync::RESUME : missing > 0 ? Resync::SLOW : Resync::FAST);
+        interrupted = false;
     }
+
+    return 0;
 }
 
 void
@@ -92,12 +175,87 @@ Thread::sleep()
 
     // Don't sleep if the emulator is running in warp mode
     if (warp && isRunning()) return;
-    
+
+    // In hybrid pacing mode, sleep and spin until the next frame is due
+    if (auto spin = spinTime(); spin && isRunning()) {
+
+        if (auto due = dueTime(); due.asNanoseconds()) {
+
+            // Let execute() resync if the thread is way ahead
+            if (due - utl::Time::now() > frameTime() * 6L) return;
+
+            pace(due, *spin);
+            return;
+        }
+    }
+
     // Set a timeout to prevent the thread from stalling
     auto timeout = utl::Time::milliseconds(50);
 
     // Wait for the next pulse
     waitForWakeUp(timeout);
+
+    // Measure the wakeup latency
+    if (auto stamp = wakeupStamp.exchange(0); stamp) {
+        wakeupLatency.record(utl::Time::now() - utl::Time(stamp));
+    }
+}
+
+void
+Thread::pace(utl::Time due, utl::Time spin)
+{
+    // Sleep until shortly before the deadline (wakeup pulses are ignored)
+    for (auto now = utl::Time::now(); now + spin < due; now = utl::Time::now()) {
+
+        waitForWakeUp(due - spin - now);
+        wakeupStamp = 0;
+    }
+
+    // Spin until the deadline has been reached
+    while (utl::Time::now() < due) std::this_thread::yield();
+}
+
+void
+Thread::setScheduling(isize core, bool realtime)
+{
+    // Only modify threads owned by this instance
+    if (farm) return;
+
+    if (core != cpuCore) {
+
+#ifdef __linux__
+        // Remember the original affinity (which respects the process cpuset)
+        if (cpuCore < 0 && pthread_getaffinity_np(pthread_self(), sizeof(affinity), &affinity) != 0) {
+            CPU_ZERO(&affinity);
+        }
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+
+        if (core >= 0) {
+            CPU_SET(int(core), &set);
+        } else {
+            set = affinity;
+        }
+        if (CPU_COUNT(&set) && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+            loginfo(RUN_DEBUG, "Failed to pin the thread to core %ld\n", core);
+        }
+#endif
+        cpuCore = core;
+    }
+
+    if (realtime != rtPriority) {
+
+#if defined(__linux__)
+        sched_param param { .sched_priority = realtime ? rtPriorityLevel : 0 };
+        if (pthread_setschedparam(pthread_self(), realtime ? SCHED_FIFO : SCHED_OTHER, &param) != 0) {
+            loginfo(RUN_DEBUG, "Failed to change the scheduling policy (missing privileges?)\n");
+        }
+#elif defined(__APPLE__)
+        pthread_set_qos_class_self_np(realtime ? QOS_CLASS_USER_INTERACTIVE : QOS_CLASS_DEFAULT, 0);
+#endif
+        rtPriority = realtime;
+    }
 }
 
 void
@@ -122,6 +280,8 @@ Thread::computeStats()
 void
 Thread::runLoop()
 {
+    owner = std::this_thread::get_id();
+    utl::Tracer::setThreadName(objectName());
     initialize();
 
     while (state != ExecState::HALTED) {
@@ -338,6 +498,11 @@ void
 Thread::wakeUp()
 {
     // logdebug(RUN_DEBUG, "wakeup: %lld us\n", wakeupClock.restart().asMicroseconds());
+
+    // Remember when the first pending wakeup call has been issued
+    i64 expected = 0;
+    wakeupStamp.compare_exchange_strong(expected, utl::Time::now().asNanoseconds());
+
     Wakeable::wakeUp();
 }
 
@@ -15,6 +15,9 @@
 #include "utl/concurrency.h"
 #include <thread>
 #include <latch>
+#ifdef __linux__
+#include <sched.h>
+#endif
 
 namespace vamiga {
 
@@ -32,10 +35,24 @@ typedef GenericException<long> StateChangeException;
  *  to another state. */
 class Thread : public CoreObject, public Wakeable {
 
+    friend class Farm;
+
+    // Priority requested in real-time scheduling mode (SCHED_FIFO)
+    static constexpr int rtPriorityLevel = 10;
+
 protected:
 
     // The thread object
     std::thread thread;
+
+    // The thread currently executing the run loop
+    std::atomic<std::thread::id> owner;
+
+    // The farm driving the run loop (if not running on an own thread)
+    class Farm *farm = nullptr;
+
+    // Set by the farm when the run loop has terminated (guarded by the farm)
+    bool retired = false;
     
     // The current thread state
     ExecState state = ExecState::OFF;
@@ -67,10 +84,34 @@ protected:
     double cpuLoad = 0.0;
     double fps = 0.0;
     isize resyncs = 0;
+    isize resyncCount[ResyncEnum::maxVal + 1] = { };
+
+    // Indicates if the thread has been paused or warped since the last frame
+    bool interrupted = true;
+
+    // Time stamp of the first pending wakeup call (0 = none)
+    std::atomic<i64> wakeupStamp = 0;
+
+    // Current scheduling parameters (see setScheduling)
+    isize cpuCore = -1;
+    bool rtPriority = false;
+
+#ifdef __linux__
+    // CPU affinity of the thread before it has been pinned to a core
+    cpu_set_t affinity;
+#endif
 
     // Debug clocks
     utl::Clock wakeupClock;
 
+public:
+
+    // Timing histograms
+    utl::Histogram computeTime;     // Time spent in computeFrame()
+    utl::Histogram overshoot;       // Delay between a frame's due time and its computation
+    utl::Histogram wakeupLatency;   // Delay between wakeUp() and the thread waking up
+    utl::Histogram deadlineMiss;    // Delay between a frame's deadline and its completion
+
     
     //
     // Initializing
@@ -84,13 +125,21 @@ public:
     const char *objectName() const override { return "Thread"; }
 
     // Checks the launch state
-    bool isLaunched() const { return thread.joinable(); }
+    bool isLaunched() const { return thread.joinable() || farm; }
 
 protected:
 
     // Launches the emulator thread
     void launch();
 
+public:
+
+    // Initializes the emulator for being driven by a farm worker
+    void host(Farm &farm);
+
+    // Runs a single iteration of the run loop (returns -1 after termination)
+    isize step();
+
 
     //
     // Executing
@@ -99,8 +148,8 @@ protected:
 public:
 
     // Returns true if this functions is called inside or outside the emulator thread
-    bool isEmulatorThread() const { return std::this_thread::get_id() == thread.get_id(); }
-    bool isUserThread() const { return std::this_thread::get_id() != thread.get_id(); }
+    bool isEmulatorThread() const { return std::this_thread::get_id() == owner.load(); }
+    bool isUserThread() const { return std::this_thread::get_id() != owner.load(); }
     
     // Performs a state change
     void switchState(ExecState newState);
@@ -116,11 +165,20 @@ private:
     // Computes the number of overdue frames (provided by the subclass)
     virtual isize missingFrames() const = 0;
 
+    // Returns the time at which the next frame is due (0 = not time-based)
+    virtual utl::Time dueTime() const = 0;
+
+    // Returns the duration of a single frame
+    virtual utl::Time frameTime() const = 0;
+
+    // Returns the busy-wait time before a frame is due (none = wait for pulses)
+    virtual optional<utl::Time> spinTime() const = 0;
+
     // The code to be executed in each iteration (implemented by the subclass)
     virtual void computeFrame() = 0;
 
     // Rectifies an out-of-sync condition. Resets all counters and clocks.
-    void resync();
+    void resync(Resync cause);
 
     /** The thread's main entry point.
      *
@@ -128,12 +186,15 @@ private:
      */
     void runLoop();
 
-    // Computes all missing frames
-    void execute();
+    // Computes all missing frames (returns the number of computed frames)
+    isize execute();
 
     // Suspends the thread till the next wakeup pulse
     void sleep();
 
+    // Suspends the thread till the next frame is due
+    void pace(utl::Time due, utl::Time spin);
+
 
     //
     // Analyzing
@@ -213,7 +274,14 @@ public:
     void wakeUp();
     
     // Wait until the thread has terminated
-    void join() { if (thread.joinable()) thread.join(); }
+    void join();
+
+protected:
+
+    // Pins the calling thread to a CPU core and adjusts its priority. The
+    // call is ignored if the run loop is driven by a farm, because the
+    // calling thread is a shared pool worker then.
+    void setScheduling(isize core, bool realtime);
 };
 
 }
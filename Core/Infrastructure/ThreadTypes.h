@@ -49,4 +49,34 @@ struct ExecStateEnum : Reflectable<ExecStateEnum, ExecState>
     }
 };
 
+/// Cause of a thread resynchronization
+enum class Resync : long
+{
+    SLOW,         ///< Emulation fell behind
+    FAST,         ///< Emulation ran ahead
+    RESUME        ///< Emulation resumed after pausing or warping
+};
+
+struct ResyncEnum : Reflectable<ResyncEnum, Resync>
+{
+    static constexpr long minVal = 0;
+    static constexpr long maxVal = long(Resync::RESUME);
+
+    static const char *_key(Resync value)
+    {
+        switch (value) {
+
+            case Resync::SLOW:         return "SLOW";
+            case Resync::FAST:         return "FAST";
+            case Resync::RESUME:       return "RESUME";
+        }
+        return "???";
+    }
+
+    static const char *help(Resync value)
+    {
+        return "";
+    }
+};
+
 }
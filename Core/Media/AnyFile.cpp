@@ -54,9 +54,10 @@ AnyFile::init(const fs::path &path)
     if (!isCompatiblePath(path)) {
         throw IOError(IOError::FILE_TYPE_MISMATCH, path);
     }
-    std::ostringstream sstr(std::ios::binary);
-    sstr << stream.rdbuf();
-    init(sstr.str());
+
+    // Map the file into memory (falls back to reading if mapping fails)
+    if (!data.map(path)) data.init(path);
+    didLoad();
     this->path = path;
 }
 
@@ -136,6 +137,9 @@ AnyFile::writeToFile(const fs::path &path, isize offset, isize len) const
         throw IOError(IOError::FILE_IS_DIRECTORY);
     }
     
+    // The target may be the mapped file itself, which must not be truncated
+    const_cast<Buffer<u8> &>(data).unmap();
+
     std::ofstream stream(path, std::ofstream::binary);
 
     if (!stream.is_open()) {
@@ -36,6 +36,11 @@ MediaError::MediaError(long code, const string &s) : Error(code)
                     " emulator into an inconsistent state.");
             break;
 
+        case SNAP_MEDIA_MISSING:
+            set_msg("The snapshot references disk or Rom data which is not"
+                    " present in the media store" + (s.empty() ? "." : ": " + s));
+            break;
+
         case MISSING_ROM_KEY:
             set_msg("No \"rom.key\" file found.");
             break;
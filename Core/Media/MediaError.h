@@ -25,6 +25,7 @@ struct MediaError : public Error {
     static constexpr long SNAP_TOO_NEW      = 11; ///< Snapshot was created with a later version
     static constexpr long SNAP_IS_BETA      = 12; ///< Snapshot was created with a beta release
     static constexpr long SNAP_CORRUPTED    = 13; ///< Snapshot data is corrupted
+    static constexpr long SNAP_MEDIA_MISSING = 14; ///< Referenced media data not found
 
     // Encrypted Roms
     static constexpr long MISSING_ROM_KEY   = 30;
@@ -41,6 +42,7 @@ struct MediaError : public Error {
             case SNAP_TOO_NEW:                return "SNAP_TOO_NEW";
             case SNAP_IS_BETA:                return "SNAP_IS_BETA";
             case SNAP_CORRUPTED:              return "SNAP_CORRUPTED";
+            case SNAP_MEDIA_MISSING:          return "SNAP_MEDIA_MISSING";
 
             case MISSING_ROM_KEY:             return "MISSING_ROM_KEY";
             case INVALID_ROM_KEY:             return "INVALID_ROM_KEY";
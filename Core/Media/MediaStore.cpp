@@ -0,0 +1,122 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the Mozilla Public License v2
+//
+// See https://mozilla.org/MPL/2.0 for license information
+// -----------------------------------------------------------------------------
+
+#include "config.h"
+#include "MediaStore.h"
+#include "MediaError.h"
+#include "utl/io.h"
+#include <fstream>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace vamiga {
+
+MediaStore::MediaStore(const fs::path &root) : root(root)
+{
+    std::error_code ec;
+    fs::create_directories(root, ec);
+
+    if (!fs::is_directory(root)) throw IOError(IOError::DIR_CANT_CREATE, root);
+}
+
+fs::path
+MediaStore::path(u64 key) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return root / name;
+}
+
+bool
+MediaStore::contains(u64 key)
+{
+    {   std::lock_guard<std::mutex> guard(mutex);
+        if (known.contains(key)) return true;
+    }
+
+    std::error_code ec;
+    if (!fs::is_regular_file(path(key), ec)) return false;
+
+    std::lock_guard<std::mutex> guard(mutex);
+    known.insert(key);
+    return true;
+}
+
+u64
+MediaStore::put(const u8 *buf, isize len)
+{
+    assert(len <= chunkSize);
+
+    auto key = Hashable::fnv64(buf, len);
+
+    if (!contains(key)) {
+
+        auto target = path(key);
+        auto tmp = target;
+        tmp += "." + std::to_string(getpid()) + "-" + std::to_string(tmpCount++) + ".tmp";
+
+        // Write to a temporary file first to never expose a partial chunk
+        std::ofstream stream(tmp, std::ios::binary);
+        stream.write((const char *)buf, std::streamsize(len));
+        stream.close();
+
+        std::error_code ec;
+        if (!stream) {
+
+            fs::remove(tmp, ec);
+            throw IOError(IOError::FILE_CANT_WRITE, tmp);
+        }
+
+        fs::rename(tmp, target, ec);
+        if (ec) {
+
+            fs::remove(tmp, ec);
+            throw IOError(IOError::FILE_CANT_WRITE, target);
+        }
+
+        std::lock_guard<std::mutex> guard(mutex);
+        known.insert(key);
+    }
+
+    return key;
+}
+
+void
+MediaStore::get(u64 key, u8 *buf, isize len)
+{
+    auto source = path(key);
+
+    std::error_code ec;
+    auto size = fs::file_size(source, ec);
+    if (ec || isize(size) != len) throw MediaError(MediaError::SNAP_MEDIA_MISSING, source);
+
+    std::ifstream stream(source, std::ios::binary);
+    stream.read((char *)buf, std::streamsize(len));
+    if (!stream) throw MediaError(MediaError::SNAP_MEDIA_MISSING, source);
+
+    // Reject chunks which have been modified or damaged on disk
+    if (Hashable::fnv64(buf, len) != key) {
+
+        // Remove the chunk to have it rewritten by the next put()
+        {   std::lock_guard<std::mutex> guard(mutex);
+            known.erase(key);
+        }
+        stream.close();
+        fs::remove(source, ec);
+
+        throw MediaError(MediaError::SNAP_MEDIA_MISSING, source);
+    }
+}
+
+}
@@ -0,0 +1,82 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the Mozilla Public License v2
+//
+// See https://mozilla.org/MPL/2.0 for license information
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "utl/common.h"
+#include "utl/abilities/Hashable.h"
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+
+namespace vamiga {
+
+using namespace utl;
+
+/* A content-addressed store for disk and Rom data. The store is a directory
+ * containing one file per chunk of data. Each file is named after the FNV-64
+ * hash of its contents. Snapshots can reference media data in the store
+ * instead of embedding it. This way, an arbitrary number of snapshots taken
+ * from the same title share a single copy of the disk and Rom contents.
+ */
+class MediaStore final {
+
+public:
+
+    // Media data is split into chunks of this size
+    static constexpr isize chunkSize = 64 * 1024;
+
+    // Returns the number of chunks needed to store a certain number of bytes
+    static isize numChunks(isize bytes) { return (bytes + chunkSize - 1) / chunkSize; }
+
+private:
+
+    // The directory holding all chunks
+    fs::path root;
+
+    // Keys of all chunks known to be present in the store
+    std::unordered_set<u64> known;
+
+    // Protects the key cache
+    std::mutex mutex;
+
+    // Counter for generating unique names for temporary files
+    std::atomic<u64> tmpCount = 0;
+
+
+    //
+    // Initializing
+    //
+
+public:
+
+    explicit MediaStore(const fs::path &root);
+
+
+    //
+    // Accessing
+    //
+
+    // Returns the root directory
+    const fs::path &getRoot() const { return root; }
+
+    // Returns the location of a chunk
+    fs::path path(u64 key) const;
+
+    // Checks if a chunk is present in the store
+    bool contains(u64 key);
+
+    // Adds a chunk to the store and returns its key
+    u64 put(const u8 *buf, isize len);
+
+    // Reads a chunk from the store (throws if the chunk is missing or damaged)
+    void get(u64 key, u8 *buf, isize len);
+};
+
+}
@@ -98,7 +98,9 @@ RomFile::isCompatible(const fs::path &path)
         
         if (size == allowed) {
             
-            Buffer<u8> buffer(path);
+            // Only the header is inspected, so there is no need to copy the file
+            Buffer<u8> buffer;
+            if (!buffer.map(path)) buffer.init(path);
             return isCompatible(buffer.ptr, buffer.size);
         }
     }
@@ -66,19 +66,23 @@ Snapshot::Snapshot(isize capacity)
     header->rawSize = i32(data.size);
 }
 
-Snapshot::Snapshot(Amiga &amiga) : Snapshot(amiga.size())
+Snapshot::Snapshot(Amiga &amiga, MediaStore *store) : Snapshot(amiga.size(true, store))
 {
+    utl::TraceSpan trace("snapshot", "take");
+
     {   utl::StopWatch(debug::SNP_DEBUG, "Taking screenshot...");
 
         takeScreenshot(amiga);
     }
     {   utl::StopWatch(debug::SNP_DEBUG, "Saving state...");
 
-        amiga.save(getData() + sizeof(SnapshotHeader));
+        amiga.save(getData() + sizeof(SnapshotHeader), store);
     }
+
+    getHeader()->mediaStore = store != nullptr;
 }
 
-Snapshot::Snapshot(Amiga &amiga, Compressor compressor) : Snapshot(amiga)
+Snapshot::Snapshot(Amiga &amiga, Compressor compressor, MediaStore *store) : Snapshot(amiga, store)
 {
     compress(compressor);
 }
@@ -154,6 +158,8 @@ Snapshot::takeScreenshot(Amiga &amiga)
 void
 Snapshot::compress(Compressor compressor)
 {
+    utl::TraceSpan trace("snapshot", "compress");
+
     loginfo(SNP_DEBUG, "compress(%s)\n", CompressorEnum::key(compressor));
 
     if (!isCompressed()) {
@@ -179,6 +185,8 @@ Snapshot::compress(Compressor compressor)
 void
 Snapshot::uncompress()
 {
+    utl::TraceSpan trace("snapshot", "uncompress");
+
     loginfo(SNP_DEBUG, "uncompress(%s)\n", CompressorEnum::key(compressor()));
 
     if (isCompressed()) {
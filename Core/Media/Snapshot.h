@@ -12,6 +12,7 @@
 #include "AnyFile.h"
 #include "Constants.h"
 #include "AmigaTypes.h"
+#include "MediaStore.h"
 
 namespace vamiga {
 
@@ -44,6 +45,9 @@ struct SnapshotHeader {
     // Applied compression method
     u8 compressor;
 
+    // Indicates whether disk and Rom data is referenced via a media store
+    u8 mediaStore;
+
     // Size of this snapshot when uncompressed
     i32 rawSize;
     
@@ -66,8 +70,8 @@ public:
     Snapshot(const fs::path &path) { init(path); }
     Snapshot(const u8 *buf, isize len) { init(buf, len); }
     Snapshot(isize capacity);
-    Snapshot(Amiga &amiga);
-    Snapshot(Amiga &amiga, Compressor compressor);
+    Snapshot(Amiga &amiga, MediaStore *store = nullptr);
+    Snapshot(Amiga &amiga, Compressor compressor, MediaStore *store = nullptr);
     
     
     //
@@ -93,6 +97,9 @@ public:
     bool isTooNew() const;
     bool isBeta() const;
     bool matches() { return !isTooOld() && !isTooNew(); }
+
+    // Checks if disk and Rom data needs to be resolved via a media store
+    bool referencesMedia() const { return getHeader()->mediaStore != 0; }
     
     // Returns a pointer to the snapshot header
     SnapshotHeader *getHeader() const { return (SnapshotHeader *)data.ptr; }
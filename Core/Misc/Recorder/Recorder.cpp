@@ -0,0 +1,409 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the Mozilla Public License v2
+//
+// See https://mozilla.org/MPL/2.0 for license information
+// -----------------------------------------------------------------------------
+
+#include "config.h"
+#include "Recorder.h"
+#include "Amiga.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace vamiga {
+
+Recorder::~Recorder()
+{
+    stopRecording();
+}
+
+void
+Recorder::_dump(Category category, std::ostream &os) const
+{
+    using namespace utl;
+
+    if (category == Category::Config) {
+
+        dumpConfig(os);
+    }
+
+    if (category == Category::State) {
+
+        auto stats = getStats();
+
+        os << tab("Recording");
+        os << bol(isRecording()) << std::endl;
+        os << tab("Video file");
+        os << (isRecording() ? videoPath.string() : "-") << std::endl;
+        os << tab("Audio file");
+        os << (isRecording() ? audioPath.string() : "-") << std::endl;
+        os << tab("Recorded area");
+        os << "(" << dec(x1) << "," << dec(y1) << ") - (" << dec(x2) << "," << dec(y2) << ")" << std::endl;
+        os << tab("Recorded frames");
+        os << dec(stats.recordedFrames) << std::endl;
+        os << tab("Dropped frames");
+        os << dec(stats.droppedFrames) << std::endl;
+        os << tab("Written frames");
+        os << dec(stats.writtenFrames) << std::endl;
+        os << tab("Written samples");
+        os << dec(stats.writtenSamples) << std::endl;
+        os << tab("Padded samples");
+        os << dec(stats.paddedSamples) << std::endl;
+    }
+}
+
+i64
+Recorder::getOption(Opt option) const
+{
+    switch (option) {
+
+        case Opt::REC_QUEUE_SIZE:   return config.queueSize;
+
+        default:
+            fatalError;
+    }
+}
+
+void
+Recorder::checkOption(Opt opt, i64 value)
+{
+    switch (opt) {
+
+        case Opt::REC_QUEUE_SIZE:
+
+            if (value < 2 || value > 512) {
+                throw CoreError(CoreError::OPT_INV_ARG, "2...512");
+            }
+            return;
+
+        default:
+            throw CoreError(CoreError::OPT_UNSUPPORTED);
+    }
+}
+
+void
+Recorder::setOption(Opt option, i64 value)
+{
+    switch (option) {
+
+        case Opt::REC_QUEUE_SIZE:
+
+            {   std::lock_guard<std::mutex> guard(mutex);
+                config.queueSize = isize(value);
+            }
+            return;
+
+        default:
+            fatalError;
+    }
+}
+
+RecorderStats
+Recorder::getStats() const
+{
+    return {
+
+        .recordedFrames = recordedFrames,
+        .droppedFrames = droppedFrames,
+        .writtenFrames = writtenFrames,
+        .writtenSamples = writtenSamples,
+        .paddedSamples = paddedSamples
+    };
+}
+
+void
+Recorder::startRecording(const fs::path &path)
+{
+    stopRecording();
+
+    // Determine the recorded area
+    videoPort.findInnerArea(x1, x2, y1, y2);
+
+    if (x1 == x2 || y1 == y2) {
+
+        // Fall back to the visible area if no inner area has been found
+        x1 = 4 * HBLANK_CNT;
+        x2 = 4 * PAL::HPOS_MAX;
+        y1 = agnus.isPAL() ? PAL::VBLANK_CNT : NTSC::VBLANK_CNT;
+        y2 = agnus.isPAL() ? PAL::VPOS_CNT_SF : NTSC::VPOS_CNT_SF;
+    }
+    x2 = std::min(x2 + 1, HPIXELS);
+    y2 = std::min(y2 + 1, VPIXELS);
+
+    // Open the output files
+    videoPath = path; videoPath += ".y4m";
+    audioPath = path; audioPath += ".wav";
+
+    video.open(videoPath, std::ios::binary | std::ios::trunc);
+    if (!video) throw IOError(IOError::FILE_CANT_CREATE, videoPath);
+
+    audio.open(audioPath, std::ios::binary | std::ios::trunc);
+    if (!audio) { video.close(); throw IOError(IOError::FILE_CANT_CREATE, audioPath); }
+
+    // Write the video header. The frame rate is derived from the master clock
+    // and averaged over a long and a short frame to cover interlace modes.
+    auto num = 2 * amiga.masterClockFrequency();
+    auto den = DMA_CYCLES(agnus.pos.cyclesPerFrames(2));
+    auto gcd = std::gcd(num, den);
+    fps = double(num) / double(den);
+
+    video << "YUV4MPEG2";
+    video << " W" << (x2 - x1) * TPP << " H" << (y2 - y1);
+    video << " F" << num / gcd << ":" << den / gcd;
+    video << " Ip A1:" << 2 * TPP << " C444" << "\n";
+
+    // Write a preliminary audio header (sizes are fixed up when stopping)
+    sampleRate = std::round(audioPort.getSampleRate());
+    writeWavHeader(0, sampleRate);
+
+    // Reset the recorder state
+    queue.clear();
+    pending.clear();
+    audioPos = audioPort.stream.end();
+    stopRequested = false;
+    skipped = 0;
+    yuv.clear();
+    lastSample = { };
+    recordedFrames = 0;
+    droppedFrames = 0;
+    writtenFrames = 0;
+    writtenSamples = 0;
+    paddedSamples = 0;
+
+    // Launch the writer thread
+    writer = std::thread(&Recorder::writerMain, this);
+
+    logdebug(VID_DEBUG, "Recording to %s\n", path.string().c_str());
+}
+
+void
+Recorder::stopRecording()
+{
+    if (!isRecording()) return;
+
+    // Let the writer thread drain the queue and terminate
+    {   std::lock_guard<std::mutex> guard(mutex);
+        stopRequested = true;
+    }
+    cond.notify_one();
+    writer.join();
+
+    // Discard all samples that don't belong to a written frame
+    pending.clear();
+
+    // Finalize the audio header
+    writeWavHeader(writtenSamples, sampleRate);
+
+    video.close();
+    audio.close();
+
+    logdebug(VID_DEBUG, "Recorded %lld frames (%lld dropped)\n",
+             (long long)writtenFrames, (long long)droppedFrames);
+}
+
+void
+Recorder::recordFrame(const Texture &texture)
+{
+    if (!isRecording()) return;
+
+    Packet packet;
+
+    {   std::lock_guard<std::mutex> guard(mutex);
+
+        // Drop the frame if the writer thread lags behind
+        if (isize(queue.size()) >= config.queueSize) {
+
+            droppedFrames++;
+            skipped++;
+            return;
+        }
+
+        // Recycle a previously written packet to avoid reallocations
+        if (!pool.empty()) { packet = std::move(pool.back()); pool.pop_back(); }
+    }
+
+    // Copy the recorded area
+    auto width = x2 - x1;
+    packet.pixels.resize(width * (y2 - y1));
+    for (isize y = y1; y < y2; y++) {
+
+        std::memcpy(packet.pixels.data() + (y - y1) * width,
+                    texture.pixels.ptr + y * HPIXELS + x1,
+                    width * sizeof(Texel));
+    }
+
+    // Attach the audio samples (including those of dropped frames)
+    packet.audio.swap(pending);
+    pending.clear();
+
+    packet.skipped = skipped;
+    skipped = 0;
+
+    {   std::lock_guard<std::mutex> guard(mutex);
+        queue.push_back(std::move(packet));
+    }
+    cond.notify_one();
+
+    recordedFrames++;
+}
+
+void
+Recorder::recordAudio(const AudioStream &stream)
+{
+    if (!isRecording()) return;
+
+    // Record the samples that have entered the stream since the last call
+    stream.copyLatest(isize(stream.end() - audioPos), [&](const SamplePair &sample) {
+        pending.push_back(sample);
+    });
+    audioPos = stream.end();
+}
+
+void
+Recorder::writerMain()
+{
+    while (true) {
+
+        Packet packet;
+
+        {   std::unique_lock<std::mutex> lock(mutex);
+
+            cond.wait(lock, [this]() { return !queue.empty() || stopRequested; });
+            if (queue.empty()) break;
+
+            packet = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        write(packet);
+
+        {   std::lock_guard<std::mutex> guard(mutex);
+            pool.push_back(std::move(packet));
+        }
+    }
+}
+
+void
+Recorder::write(const Packet &packet)
+{
+    auto writeFrame = [&]() {
+
+        video << "FRAME\n";
+        video.write((const char *)yuv.data(), std::streamsize(yuv.size()));
+        writtenFrames++;
+    };
+
+    // Fill the gap of dropped frames by repeating the last frame
+    if (!yuv.empty()) {
+        for (isize i = 0; i < packet.skipped; i++) writeFrame();
+    }
+
+    convert(packet);
+    writeFrame();
+
+    /* The audio stream must cover exactly the duration of the written frames.
+     * Otherwise, the audio drifts away from the video or plays at a different
+     * pitch. Hence, the samples of each packet are stretched or squeezed to
+     * the nominal number of samples. Packets without any samples are filled
+     * up by repeating the latest sample.
+     */
+    auto count = isize(std::llround(double(writtenFrames) * samplesPerFrame()) - writtenSamples);
+    auto &src = packet.audio;
+    auto n = isize(src.size());
+
+    resampled.resize(count);
+
+    if (n == 0) {
+
+        std::fill(resampled.begin(), resampled.end(), lastSample);
+        paddedSamples += count;
+
+    } else {
+
+        for (isize i = 0; i < count; i++) {
+
+            // Interpolate linearly between the two closest source samples
+            auto pos = std::clamp((double(i) + 0.5) * double(n) / double(count) - 0.5, 0.0, double(n - 1));
+            auto i0 = isize(pos);
+            auto i1 = std::min(i0 + 1, n - 1);
+            auto w = float(pos - double(i0));
+
+            resampled[i] = { src[i0].l + w * (src[i1].l - src[i0].l), src[i0].r + w * (src[i1].r - src[i0].r) };
+        }
+        lastSample = src.back();
+    }
+
+    audio.write((const char *)resampled.data(), std::streamsize(count * sizeof(SamplePair)));
+    writtenSamples += count;
+
+    if (!video || !audio) {
+
+        loginfo(VID_DEBUG, "Failed to write %s\n", (!video ? videoPath : audioPath).string().c_str());
+        video.clear();
+        audio.clear();
+    }
+}
+
+void
+Recorder::convert(const Packet &packet)
+{
+    // Texels are composed of RGBA pixels (red in the lowest byte)
+    auto src = (const u32 *)packet.pixels.data();
+    auto count = isize(packet.pixels.size()) * TPP;
+
+    yuv.resize(3 * count);
+    auto yp = yuv.data();
+    auto up = yp + count;
+    auto vp = up + count;
+
+    // Convert to studio-range YCbCr (ITU-R BT.601)
+    for (isize i = 0; i < count; i++) {
+
+        auto r = int(src[i] & 0xFF);
+        auto g = int(src[i] >> 8 & 0xFF);
+        auto b = int(src[i] >> 16 & 0xFF);
+
+        yp[i] = u8(((  66 * r + 129 * g +  25 * b + 128) >> 8) +  16);
+        up[i] = u8((( -38 * r -  74 * g + 112 * b + 128) >> 8) + 128);
+        vp[i] = u8(((112 * r -  94 * g -  18 * b + 128) >> 8) + 128);
+    }
+}
+
+void
+Recorder::writeWavHeader(i64 samples, double sampleRate)
+{
+    auto put16 = [&](u16 value) { audio.put(char(value & 0xFF)); audio.put(char(value >> 8)); };
+    auto put32 = [&](u32 value) { put16(u16(value & 0xFFFF)); put16(u16(value >> 16)); };
+
+    auto rate = u32(std::round(sampleRate));
+    auto bytes = u32(samples * sizeof(SamplePair));
+
+    audio.seekp(0);
+
+    // RIFF header
+    audio.write("RIFF", 4);
+    put32(36 + bytes);
+    audio.write("WAVE", 4);
+
+    // Format chunk (IEEE float, two channels)
+    audio.write("fmt ", 4);
+    put32(16);
+    put16(3);
+    put16(2);
+    put32(rate);
+    put32(rate * u32(sizeof(SamplePair)));
+    put16(u16(sizeof(SamplePair)));
+    put16(32);
+
+    // Data chunk
+    audio.write("data", 4);
+    put32(bytes);
+
+    audio.seekp(0, std::ios::end);
+}
+
+}
@@ -0,0 +1,226 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the Mozilla Public License v2
+//
+// See https://mozilla.org/MPL/2.0 for license information
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "RecorderTypes.h"
+#include "SubComponent.h"
+#include "FrameBufferTypes.h"
+#include "AudioStream.h"
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <thread>
+
+namespace vamiga {
+
+/* The recorder captures the emulator output in uncompressed form. The video
+ * stream is written as a YUV4MPEG2 file (4:4:4, BT.601) and the audio stream
+ * as a WAV file (32-bit float, stereo).
+ *
+ * The emulator thread only copies data. At the end of each frame, the inner
+ * area of the completed texture is copied into a packet, together with all
+ * audio samples synthesized during that frame. The packet is appended to a
+ * queue which is drained by a background writer thread. If the queue is
+ * full, the frame is dropped and its audio samples are handed over with the
+ * next packet. The writer fills the gap by repeating the last frame. This way,
+ * the emulator never waits for the disk and the video and audio streams stay
+ * in sync on a frame-by-frame basis.
+ *
+ * Because the audio port adapts its sample rate to the fill level of the
+ * audio buffer, the number of samples per frame may slightly differ from the
+ * nominal value. When the recording stops, the sample rate stored in the WAV
+ * header is adjusted such that both streams have the same duration.
+ */
+class Recorder final : public SubComponent {
+
+    Descriptions descriptions = {{
+
+        .type           = Class::Recorder,
+        .name           = "Recorder",
+        .description    = "Screen Recorder",
+        .shell          = "recorder"
+    }};
+
+    Options options = {
+
+        Opt::REC_QUEUE_SIZE
+    };
+
+    // A single frame together with the audio samples belonging to it
+    struct Packet {
+
+        // Number of frames dropped right before this one
+        isize skipped = 0;
+
+        // Texels of the recorded area
+        std::vector<Texel> pixels;
+
+        // Audio samples synthesized since the previous packet
+        std::vector<SamplePair> audio;
+    };
+
+    // Current configuration
+    RecorderConfig config = { };
+
+    // Output files
+    fs::path videoPath;
+    fs::path audioPath;
+    std::ofstream video;
+    std::ofstream audio;
+
+    // Recorded area (texture coordinates, exclusive upper bounds)
+    isize x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+
+    // Frame rate of the video stream
+    double fps = 0.0;
+
+    // Sample rate of the audio stream
+    double sampleRate = 0.0;
+
+    // Packets waiting to be written
+    std::deque<Packet> queue;
+
+    // Packets that have been written and can be reused
+    std::vector<Packet> pool;
+
+    // Audio samples collected since the last packet was queued
+    std::vector<SamplePair> pending;
+
+    // Stream position of the next audio sample to be recorded
+    i64 audioPos = 0;
+
+    // Number of frames dropped since the last packet was queued
+    isize skipped = 0;
+
+    // The writer thread
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable cond;
+    bool stopRequested = false;
+
+    // The most recently converted frame (owned by the writer thread)
+    std::vector<u8> yuv;
+
+    // Audio samples of the most recently written frame (owned by the writer thread)
+    std::vector<SamplePair> resampled;
+
+    // The most recently written audio sample (owned by the writer thread)
+    SamplePair lastSample = { };
+
+    // Statistics
+    std::atomic<i64> recordedFrames = 0;
+    std::atomic<i64> droppedFrames = 0;
+    std::atomic<i64> writtenFrames = 0;
+    std::atomic<i64> writtenSamples = 0;
+    std::atomic<i64> paddedSamples = 0;
+
+
+    //
+    // Constructing
+    //
+
+public:
+
+    using SubComponent::SubComponent;
+    ~Recorder();
+
+    Recorder& operator= (const Recorder& other) {
+
+        return *this;
+    }
+
+
+    //
+    // Methods from CoreObject
+    //
+
+private:
+
+    void _dump(Category category, std::ostream &os) const override;
+
+
+    //
+    // Methods from CoreComponent
+    //
+
+public:
+
+    const Descriptions &getDescriptions() const override { return descriptions; }
+
+
+    //
+    // Serializing
+    //
+
+    template <class T> void serialize(T& worker) { } SERIALIZERS(serialize);
+
+
+    //
+    // Methods from Configurable
+    //
+
+public:
+
+    const RecorderConfig &getConfig() const { return config; }
+    const Options &getOptions() const override { return options; }
+    i64 getOption(Opt option) const override;
+    void checkOption(Opt opt, i64 value) override;
+    void setOption(Opt option, i64 value) override;
+
+
+    //
+    // Analyzing
+    //
+
+public:
+
+    RecorderStats getStats() const;
+
+    // Returns the number of audio samples per video frame of the latest recording
+    double samplesPerFrame() const { return sampleRate / fps; }
+
+
+    //
+    // Recording
+    //
+
+public:
+
+    // Indicates whether a recording is in progress
+    bool isRecording() const { return writer.joinable(); }
+
+    // Starts a recording (creates <path>.y4m and <path>.wav)
+    void startRecording(const fs::path &path);
+
+    // Stops the recording and finalizes the output files
+    void stopRecording();
+
+    // Called by the pixel engine at the end of each frame
+    void recordFrame(const class Texture &texture);
+
+    // Called by the audio port after new samples have been synthesized
+    void recordAudio(const AudioStream &stream);
+
+private:
+
+    // Main function of the writer thread
+    void writerMain();
+
+    // Writes a single packet to disk
+    void write(const Packet &packet);
+
+    // Converts the texels of a packet into planar YUV
+    void convert(const Packet &packet);
+
+    // Writes the WAV file header
+    void writeWavHeader(i64 samples, double rate);
+};
+
+}
@@ -0,0 +1,46 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the Mozilla Public License v2
+//
+// See https://mozilla.org/MPL/2.0 for license information
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "BasicTypes.h"
+
+namespace vamiga {
+
+//
+// Structures
+//
+
+typedef struct
+{
+    // Maximum number of frames waiting to be written to disk
+    isize queueSize;
+}
+RecorderConfig;
+
+typedef struct
+{
+    // Frames handed over to the writer thread
+    i64 recordedFrames;
+
+    // Frames that did not fit into the queue
+    i64 droppedFrames;
+
+    // Frames written to disk (including duplicates of dropped frames)
+    i64 writtenFrames;
+
+    // Audio samples written to disk
+    i64 writtenSamples;
+
+    // Audio samples inserted for frames without any audio data
+    i64 paddedSamples;
+}
+RecorderStats;
+
+}
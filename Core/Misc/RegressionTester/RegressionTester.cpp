@@ -67,16 +67,31 @@ RegressionTester::dumpTexture(Amiga &amiga, const fs::path &path)
     /* This function is used for automatic regression testing. It dumps the
      * visible portion of the texture into the /tmp directory and exits the
      * application. The regression test script picks up the texture and
-     * compares it against a previously recorded reference image.
+     * compares it against a previously recorded reference image. If a
+     * reference folder is set, the comparison is carried out in memory and
+     * the texture is only written to disk if it differs from the reference.
      */
-    std::ofstream file;
+    auto file = (fs::path("/tmp") / path).replace_extension(".raw");
 
-    // Open an output stream
-    file.open((fs::path("/tmp") / path).replace_extension(".raw"));
-        
-    // Dump texture
-    dumpTexture(amiga, file);
-    file.close();
+    // Grab the texture
+    Buffer<u8> texture;
+    grabTexture(amiga, texture);
+    textureHash = texture.fnv64();
+
+    // Compare the texture with the reference image
+    mismatch = false;
+    if (!referencePath.empty()) {
+
+        auto reference = referencePath / file.filename();
+        mismatch = !fs::exists(reference) || Buffer<u8>(reference).fnv64() != textureHash;
+    }
+
+    // Write the texture if no reference exists or the reference differs
+    if (referencePath.empty() || mismatch) {
+
+        std::ofstream os(file, std::ios::binary);
+        os.write((const char *)texture.ptr, texture.size);
+    }
 
     // Ask the GUI to quit
     msgQueue.put(Msg::ABORT, retValue);
@@ -84,30 +99,41 @@ RegressionTester::dumpTexture(Amiga &amiga, const fs::path &path)
 
 void
 RegressionTester::dumpTexture(Amiga &amiga, std::ostream &os)
+{
+    Buffer<u8> texture;
+    grabTexture(amiga, texture);
+    os.write((const char *)texture.ptr, texture.size);
+}
+
+void
+RegressionTester::grabTexture(Amiga &amiga, Buffer<u8> &buffer)
 {
     Texel grey2 = Texture::grey2;
     Texel grey4 = Texture::grey4;
 
     auto checkerboard = [&](isize y, isize x) {
-        return ((y >> 3) & 1) == ((x >> 3) & 1) ? (char *)&grey2 : (char *)&grey4;
+        return ((y >> 3) & 1) == ((x >> 3) & 1) ? (u8 *)&grey2 : (u8 *)&grey4;
     };
     
     Texel *ptr = amiga.denise.pixelEngine.stablePtr() - 4 * HBLANK_MIN;
-    char *cptr;
-    
+    u8 *cptr;
+
+    buffer.init(3 * (Y2 - Y1) * (X2 - X1));
+    u8 *dst = buffer.ptr;
+
     for (isize y = Y1; y < Y2; y++) {
         
         for (isize x = X1; x < X2; x++) {
             
             if (y >= y1 && y < y2 && x >= x1 && x < x2) {
-                cptr = (char *)(ptr + y * HPIXELS + x);
+                cptr = (u8 *)(ptr + y * HPIXELS + x);
             } else {
                 cptr = checkerboard(y, x);
             }
             
-            os.write(cptr + 0, 1);
-            os.write(cptr + 1, 1);
-            os.write(cptr + 2, 1);
+            *dst++ = cptr[0];
+            *dst++ = cptr[1];
+            *dst++ = cptr[2];
         }
     }
 }
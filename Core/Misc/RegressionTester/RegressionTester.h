@@ -44,7 +44,16 @@ public:
     isize y1 = Y1;
     isize x2 = X2;
     isize y2 = Y2;
-    
+
+    // Folder with reference images (if set, images are compared in memory)
+    fs::path referencePath;
+
+    // Hash value of the latest test image
+    u64 textureHash = 0;
+
+    // Indicates whether the latest test image differs from its reference
+    bool mismatch = false;
+
 private:
     
     // When the emulator exits, this value is returned to the test script
@@ -113,6 +122,9 @@ public:
     void dumpTexture(Amiga &amiga, const fs::path &filename);
     void dumpTexture(Amiga &amiga, std::ostream &os);
 
+    // Copies the visible portion of the texture into a buffer
+    void grabTexture(Amiga &amiga, Buffer<u8> &buffer);
+
     
     //
     // Handling errors
@@ -0,0 +1,240 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the Mozilla Public License v2
+//
+// See https://mozilla.org/MPL/2.0 for license information
+// -----------------------------------------------------------------------------
+
+#include "config.h"
+#include "FrameServer.h"
+#include "Emulator.h"
+#include "httplib.h"
+
+// PNG encoder from the vendored miniz library (compiled as part of zip.c)
+extern "C" {
+void *tdefl_write_image_to_png_file_in_memory_ex(const void *pImage, int w, int h,
+                                                 int num_chans, size_t *pLen_out,
+                                                 unsigned level, int flip);
+void mz_free(void *p);
+}
+
+namespace vamiga {
+
+void
+FrameServer::_dump(Category category, std::ostream &os) const
+{
+    using namespace utl;
+
+    HttpServer::_dump(category, os);
+
+    if (category == Category::State) {
+
+        os << tab("Captured frames");
+        os << dec(capturedFrames) << std::endl;
+        os << tab("Skipped frames");
+        os << dec(skippedFrames) << std::endl;
+        os << tab("Served frames");
+        os << dec(servedFrames) << std::endl;
+    }
+}
+
+void
+FrameServer::main()
+{
+    try {
+
+        // Create the HTTP server
+        if (!srv) srv = new httplib::Server();
+
+        // Launch the encoder
+        {   std::lock_guard<std::mutex> guard(mutex);
+            stopping = false;
+        }
+        encoder = std::thread(&FrameServer::encoderMain, this);
+
+        // Serve the latest frame
+        srv->Get("/frame.png", [this](const httplib::Request& req, httplib::Response& res) {
+
+            switchState(SrvState::CONNECTED);
+
+            i64 seq = -1;
+            if (auto frame = waitForFrame(seq)) {
+
+                res.set_content(*frame, "image/png");
+                servedFrames++;
+
+            } else {
+
+                res.status = 503;
+            }
+        });
+
+        // Serve a continuous stream of frames
+        srv->Get("/stream", [this](const httplib::Request& req, httplib::Response& res) {
+
+            switchState(SrvState::CONNECTED);
+
+            isize fps = defaultStreamRate;
+            if (req.has_param("fps")) {
+                try { fps = std::clamp(isize(std::stol(req.get_param_value("fps"))), isize(1), maxStreamRate); } catch (...) { }
+            }
+
+            auto seq = std::make_shared<i64>(-1);
+
+            res.set_chunked_content_provider("multipart/x-mixed-replace; boundary=frame",
+                                             [this, fps, seq](size_t offset, httplib::DataSink &sink) {
+
+                auto start = utl::Time::now();
+
+                auto frame = waitForFrame(*seq);
+                if (!srv->is_running()) return false;
+
+                if (frame) {
+
+                    auto header =
+                    "--frame\r\n"
+                    "Content-Type: image/png\r\n"
+                    "Content-Length: " + std::to_string(frame->size()) + "\r\n\r\n";
+
+                    if (!sink.write(header.data(), header.size())) return false;
+                    if (!sink.write(frame->data(), frame->size())) return false;
+                    if (!sink.write("\r\n", 2)) return false;
+                    servedFrames++;
+                }
+
+                // Limit the frame rate
+                (start + utl::Time::seconds(1.0 / double(fps))).sleepUntil();
+                return true;
+            });
+        });
+
+        // Start the server to listen on localhost
+        loginfo(SRV_DEBUG, "Starting frame server\n");
+        srv->listen("localhost", (int)config.port);
+
+    } catch (std::exception &err) {
+
+        loginfo(SRV_DEBUG, "Server thread interrupted\n");
+        handleError(err.what());
+    }
+
+    // Shut down the encoder
+    {   std::lock_guard<std::mutex> guard(mutex);
+        stopping = true;
+    }
+    encoderCond.notify_all();
+    if (encoder.joinable()) encoder.join();
+}
+
+void
+FrameServer::disconnect()
+{
+    // Release all waiting clients
+    {   std::lock_guard<std::mutex> guard(mutex);
+        stopping = true;
+    }
+    clientCond.notify_all();
+    encoderCond.notify_all();
+
+    HttpServer::disconnect();
+}
+
+void
+FrameServer::captureFrame(const Texture &texture)
+{
+    // Skip the frame if the encoder is still busy with the previous one
+    int expected = IDLE;
+    if (!stage.compare_exchange_strong(expected, FILLING)) { skippedFrames++; return; }
+
+    // Copy the visible area
+    auto x1 = 4 * HBLANK_CNT;
+    auto x2 = 4 * PAL::HPOS_MAX;
+    auto y1 = agnus.isPAL() ? PAL::VBLANK_CNT : NTSC::VBLANK_CNT;
+    auto y2 = agnus.isPAL() ? PAL::VPOS_CNT_SF : NTSC::VPOS_CNT_SF;
+
+    stagingWidth = x2 - x1;
+    stagingHeight = y2 - y1;
+    staging.resize(stagingWidth * stagingHeight);
+
+    for (isize y = y1; y < y2; y++) {
+
+        std::memcpy(staging.data() + (y - y1) * stagingWidth,
+                    texture.pixels.ptr + y * HPIXELS + x1,
+                    stagingWidth * sizeof(Texel));
+    }
+    capturedFrames++;
+
+    // Hand the frame over to the encoder
+    stage = READY;
+    {   std::lock_guard<std::mutex> guard(mutex); }
+    encoderCond.notify_one();
+}
+
+void
+FrameServer::encoderMain()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+
+        encoderCond.wait(lock, [this]() { return stage == READY || stopping; });
+        if (stopping) break;
+
+        // Encode the staged frame (outside the lock)
+        lock.unlock();
+
+        utl::TraceSpan trace("server", "FrameServer::encode");
+
+        size_t size = 0;
+        auto data = tdefl_write_image_to_png_file_in_memory_ex(staging.data(),
+                                                               int(stagingWidth * TPP),
+                                                               int(stagingHeight),
+                                                               4, &size, 1, 0);
+        auto result = data ? std::make_shared<const string>((const char *)data, size) : nullptr;
+        mz_free(data);
+
+        stage = IDLE;
+        lock.lock();
+
+        // Publish the image
+        if (result) { png = result; pngSeq++; }
+        clientCond.notify_all();
+    }
+}
+
+std::shared_ptr<const string>
+FrameServer::waitForFrame(i64 &seq)
+{
+    static const auto timeout = std::chrono::milliseconds(200);
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // Ask for a frame newer than the current one if no number is given
+    if (seq < 0) seq = pngSeq;
+
+    waiting++;
+
+    for (isize attempt = 0; attempt < 2 && !stopping; attempt++) {
+
+        if (clientCond.wait_for(lock, timeout, [&]() { return pngSeq > seq || stopping; })) break;
+
+        // No frames are coming in while the emulator is paused
+        if (!emulator.isRunning()) {
+
+            lock.unlock();
+            emulator.lockTexture();
+            captureFrame(emulator.getTexture());
+            emulator.unlockTexture();
+            lock.lock();
+        }
+    }
+
+    waiting--;
+
+    seq = pngSeq;
+    return png;
+}
+
+}
@@ -0,0 +1,117 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the Mozilla Public License v2
+//
+// See https://mozilla.org/MPL/2.0 for license information
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "HttpServer.h"
+#include "FrameBufferTypes.h"
+#include <condition_variable>
+
+namespace vamiga {
+
+/* The frame server provides a visual probe for headless instances. It serves
+ * two endpoints:
+ *
+ *      /frame.png : The latest frame as a PNG image
+ *      /stream    : A multipart stream of PNG images (?fps=<n>, default 10)
+ *
+ * The emulator thread only copies the visible area of a completed frame into
+ * a staging buffer, and only if a client is waiting for a frame and the
+ * staging buffer is free. PNG encoding is carried out by a separate encoder
+ * thread. All clients share the most recently encoded image. Frames arriving
+ * while the encoder is busy are skipped, so slow clients never slow down the
+ * emulator.
+ */
+class FrameServer final : public HttpServer {
+
+    // Frame rates of the multipart stream
+    static constexpr isize defaultStreamRate = 10;
+    static constexpr isize maxStreamRate = 50;
+
+    // States of the staging buffer
+    enum { IDLE, FILLING, READY };
+
+    // Frame handed over by the emulator thread
+    std::vector<Texel> staging;
+    isize stagingWidth = 0;
+    isize stagingHeight = 0;
+    std::atomic<int> stage = IDLE;
+
+    // Number of clients waiting for a new frame
+    std::atomic<isize> waiting = 0;
+
+    // The encoder thread
+    std::thread encoder;
+    std::mutex mutex;
+    std::condition_variable encoderCond;
+    std::condition_variable clientCond;
+    bool stopping = false;
+
+    // The most recently encoded frame
+    std::shared_ptr<const string> png;
+    i64 pngSeq = 0;
+
+    // Statistics
+    std::atomic<i64> capturedFrames = 0;
+    std::atomic<i64> skippedFrames = 0;
+    std::atomic<i64> servedFrames = 0;
+
+public:
+
+    using HttpServer::HttpServer;
+
+    FrameServer& operator= (const FrameServer& other) {
+
+        HttpServer::operator = (other);
+        return *this;
+    }
+
+
+    //
+    // Methods from CoreObject
+    //
+
+protected:
+
+    void _dump(Category category, std::ostream &os) const override;
+
+
+    //
+    // Methods from RemoteServer
+    //
+
+public:
+
+    virtual bool canRun() override { return true; }
+    void main() override;
+    void disconnect() override;
+
+
+    //
+    // Capturing frames
+    //
+
+public:
+
+    // Indicates whether a client is waiting for a frame
+    bool wantsFrame() const { return waiting > 0; }
+
+    // Called by the pixel engine at the end of a frame
+    void captureFrame(const class Texture &texture);
+
+private:
+
+    // Main function of the encoder thread
+    void encoderMain();
+
+    // Waits for a frame that is newer than the one with the provided number
+    std::shared_ptr<const string> waitForFrame(i64 &seq);
+};
+
+}
@@ -52,7 +52,34 @@ PromServer::respond(const httplib::Request& request)
         output << " " << value << "\n\n";
     };
     
-    output << std::fixed << std::setprecision(4);
+    auto histogram = [&](const string& metric,
+                         const string& help,
+                         const utl::Histogram& h,
+                         const string& component) {
+
+        if (!help.empty()) {
+            output << "# HELP " << metric << " " << help << "\n";
+        }
+        output << "# TYPE " << metric << " histogram\n";
+
+        // Buckets are cumulative in Prometheus
+        i64 cumulative = 0;
+        for (isize i = 0; i < utl::Histogram::numBuckets; i++) {
+
+            cumulative += h.bucket(i);
+            auto le = i < utl::Histogram::numBuckets - 1 ? std::to_string(utl::Histogram::bound(i)) : "+Inf";
+            output << metric << "_bucket{component=\"" << component << "\",le=\"" << le << "\"} " << cumulative << "\n";
+        }
+        output << metric << "_sum{component=\"" << component << "\"} " << double(h.getSum().asNanoseconds()) / 1e9 << "\n";
+        output << metric << "_count{component=\"" << component << "\"} " << h.count() << "\n\n";
+
+        // Tail latencies
+        translate(metric + "_p50", "", "gauge", h.quantile(0.5).asSeconds(), {{"component",component}});
+        translate(metric + "_p99", "", "gauge", h.quantile(0.99).asSeconds(), {{"component",component}});
+        translate(metric + "_max", "", "gauge", h.getMax().asSeconds(), {{"component",component}});
+    };
+
+    output << std::fixed << std::setprecision(6);
     
     {   auto metrics = emulator.metrics.current();
 
@@ -67,6 +94,25 @@ PromServer::respond(const httplib::Request& request)
         translate("vamiga_resyncs", "",
                   "gauge", metrics.resyncs,
                   {{"component","emulator"}});
+
+        for (isize i = 0; i <= ResyncEnum::maxVal; i++) {
+
+            translate("vamiga_resyncs_total", "",
+                      "counter", metrics.resyncCount[i],
+                      {{"component","emulator"},{"cause",utl::lowercased(ResyncEnum::key(Resync(i)))}});
+        }
+    }
+
+    {   histogram("vamiga_frame_compute_seconds", "Time spent computing a frame",
+                  emulator.computeTime, "emulator");
+        histogram("vamiga_frame_overshoot_seconds", "Delay between a frame's due time and its computation",
+                  emulator.overshoot, "emulator");
+        histogram("vamiga_wakeup_latency_seconds", "Delay between a wakeup call and the thread waking up",
+                  emulator.wakeupLatency, "emulator");
+        histogram("vamiga_deadline_miss_seconds", "Delay between a frame's deadline and its completion",
+                  emulator.deadlineMiss, "emulator");
+        histogram("vamiga_texture_lock_wait_seconds", "Time spent waiting for the texture lock",
+                  emulator.lockWait, "emulator");
     }
     
     {   auto metrics = agnus.metrics.current();
@@ -179,6 +225,19 @@ PromServer::respond(const httplib::Request& request)
                   "gauge", metrics.fillLevel,
                   {{"component","audio"}});
     }
+
+    {   auto stats = recorder.getStats();
+
+        translate("vamiga_recorder_frames", "",
+                  "counter", stats.recordedFrames,
+                  {{"component","recorder"},{"type","recorded"}});
+        translate("vamiga_recorder_frames", "",
+                  "counter", stats.droppedFrames,
+                  {{"component","recorder"},{"type","dropped"}});
+        translate("vamiga_recorder_frames", "",
+                  "counter", stats.writtenFrames,
+                  {{"component","recorder"},{"type","written"}});
+    }
         
     return output.str();
 }
@@ -194,6 +253,8 @@ PromServer::main()
         // Define the "/metrics" endpoint where Prometheus will scrape metrics
         srv->Get("/metrics", [this](const httplib::Request& req, httplib::Response& res) {
             
+            utl::TraceSpan trace("server", "PromServer::respond");
+
             switchState(SrvState::CONNECTED);
             res.set_content(respond(req), "text/plain");
         });
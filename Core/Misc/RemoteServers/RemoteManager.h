@@ -15,6 +15,7 @@
 #include "RpcServer.h"
 #include "GdbServer.h"
 #include "PromServer.h"
+#include "FrameServer.h"
 #include "SerServer.h"
 #include "utl/wrappers.h"
 
@@ -51,10 +52,11 @@ public:
     GdbServer gdbServer = GdbServer(amiga, isize(ServerType::GDB));
     PromServer promServer = PromServer(amiga, isize(ServerType::PROM));
     SerServer serServer = SerServer(amiga, isize(ServerType::SER));
+    FrameServer frameServer = FrameServer(amiga, isize(ServerType::FRAME));
 
     // Convenience access
     std::vector <RemoteServer *> servers = {
-        &rshServer, &rpcServer, &gdbServer, &promServer, &serServer
+        &rshServer, &rpcServer, &gdbServer, &promServer, &serServer, &frameServer
     };
 
     
@@ -73,6 +75,7 @@ public:
         CLONE(gdbServer)
         CLONE(promServer)
         CLONE(serServer)
+        CLONE(frameServer)
 
         return *this;
     }
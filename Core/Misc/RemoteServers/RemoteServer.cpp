@@ -156,7 +156,11 @@ RemoteServer::start()
     if (serverThread.joinable()) serverThread.join();
 
     // Spawn a new thread
-    serverThread = std::thread(&RemoteServer::main, this);
+    serverThread = std::thread([this]() {
+
+        utl::Tracer::setThreadName(objectName());
+        main();
+    });
 }
 
 void
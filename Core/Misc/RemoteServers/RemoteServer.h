@@ -44,6 +44,10 @@ class RemoteServer : public SubComponent {
         .name           = "SerServer",
         .description    = "Serial Port Server",
         .shell          = "server ser"
+    }, {
+        .name           = "FrameServer",
+        .description    = "Frame Server",
+        .shell          = "server frame"
     }};
 
     Options options = {
@@ -10,6 +10,7 @@
 #include "config.h"
 #include "RpcServer.h"
 #include "Emulator.h"
+#include "ServerError.h"
 #include "json.h"
 #include "utl/support.h"
 #include <thread>
@@ -18,6 +19,173 @@ namespace vamiga {
 
 using nlohmann::json;
 
+namespace {
+
+// Maximum number of frames emulated by a single emu.advance request (one
+// minute of PAL time). Requests are processed in the emulator thread, which
+// must not be blocked for long. Longer runs are split up by the client.
+constexpr i64 maxAdvance = 3000;
+
+// Reports a malformed request back to the client
+struct RpcError : std::runtime_error {
+
+    long code;
+    RpcError(long code, const string &msg) : std::runtime_error(msg), code(code) { }
+};
+
+json
+makeError(i64 code, const string &message, const json &id)
+{
+    return {
+
+        {"jsonrpc", "2.0"},
+        {"error", {{"code", code}, {"message", message}}},
+        {"id", id}
+    };
+}
+
+i64
+intArg(const json &params, const char *key, std::optional<i64> fallback = { })
+{
+    if (!params.contains(key)) {
+
+        if (fallback) return *fallback;
+        throw RpcError(RPC::INVALID_PARAMS, "Missing '" + string(key) + "'");
+    }
+    if (!params[key].is_number_integer()) {
+        throw RpcError(RPC::INVALID_PARAMS, "'" + string(key) + "' must be an integer");
+    }
+    return params[key].get<i64>();
+}
+
+string
+stringArg(const json &params, const char *key, std::optional<string> fallback = { })
+{
+    if (!params.contains(key)) {
+
+        if (fallback) return *fallback;
+        throw RpcError(RPC::INVALID_PARAMS, "Missing '" + string(key) + "'");
+    }
+    if (!params[key].is_string()) {
+        throw RpcError(RPC::INVALID_PARAMS, "'" + string(key) + "' must be a string");
+    }
+    return params[key].get<string>();
+}
+
+bool
+useBase64(const json &params)
+{
+    auto encoding = stringArg(params, "encoding", "hex");
+
+    if (encoding == "hex") return false;
+    if (encoding == "base64") return true;
+
+    throw RpcError(RPC::INVALID_PARAMS, "'encoding' must be 'hex' or 'base64'");
+}
+
+const char *b64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+string
+encode(const std::vector<u8> &data, bool base64)
+{
+    string result;
+
+    if (base64) {
+
+        result.reserve((data.size() + 2) / 3 * 4);
+
+        for (usize i = 0; i < data.size(); i += 3) {
+
+            u32 bits = u32(data[i]) << 16;
+            if (i + 1 < data.size()) bits |= u32(data[i + 1]) << 8;
+            if (i + 2 < data.size()) bits |= u32(data[i + 2]);
+
+            result += b64[(bits >> 18) & 0x3F];
+            result += b64[(bits >> 12) & 0x3F];
+            result += i + 1 < data.size() ? b64[(bits >> 6) & 0x3F] : '=';
+            result += i + 2 < data.size() ? b64[bits & 0x3F] : '=';
+        }
+
+    } else {
+
+        static const char *hex = "0123456789abcdef";
+        result.reserve(2 * data.size());
+
+        for (auto byte : data) {
+
+            result += hex[byte >> 4];
+            result += hex[byte & 0xF];
+        }
+    }
+
+    return result;
+}
+
+json
+encode(std::vector<u8> &&data, const json &params, bool binary)
+{
+    // Binary frames carry byte strings natively unless an encoding is requested
+    if (binary && !params.contains("encoding")) return json::binary(std::move(data));
+
+    return encode(data, useBase64(params));
+}
+
+std::vector<u8>
+decode(const string &str, bool base64)
+{
+    std::vector<u8> result;
+
+    auto invalid = [&]() {
+        return RpcError(RPC::INVALID_PARAMS, "'data' is not " + string(base64 ? "base64" : "hex") + " encoded");
+    };
+
+    if (base64) {
+
+        if (str.size() % 4) throw invalid();
+        result.reserve(str.size() / 4 * 3);
+
+        u32 bits = 0; isize count = 0;
+        for (usize i = 0; i < str.size(); i++) {
+
+            auto c = str[i];
+            if (c == '=') { if (i + 2 < str.size()) throw invalid(); break; }
+
+            auto pos = strchr(b64, c);
+            if (!c || !pos) throw invalid();
+
+            bits = bits << 6 | u32(pos - b64);
+            if (++count == 4) {
+
+                result.push_back(u8(bits >> 16));
+                result.push_back(u8(bits >> 8));
+                result.push_back(u8(bits));
+                bits = 0; count = 0;
+            }
+        }
+        if (count == 2) result.push_back(u8(bits >> 4));
+        if (count == 3) { result.push_back(u8(bits >> 10)); result.push_back(u8(bits >> 2)); }
+
+    } else {
+
+        if (str.size() % 2) throw invalid();
+        result.reserve(str.size() / 2);
+
+        auto nibble = [&](char c) {
+            if (c >= '0' && c <= '9') return u8(c - '0');
+            if (c >= 'a' && c <= 'f') return u8(c - 'a' + 10);
+            if (c >= 'A' && c <= 'F') return u8(c - 'A' + 10);
+            throw invalid();
+        };
+        for (usize i = 0; i < str.size(); i += 2) {
+            result.push_back(u8(nibble(str[i]) << 4 | nibble(str[i + 1])));
+        }
+    }
+
+    return result;
+}
+
+}
+
 void
 RpcServer::_initialize()
 {
@@ -41,13 +209,59 @@ RpcServer::didStart()
     }
 }
 
+void
+RpcServer::didConnect()
+{
+    inbox.clear();
+}
+
 string
 RpcServer::doReceive()
 {
-    string payload = connection.recv();
+    /* Requests are transmitted in one of two formats:
+     *
+     *   Text:   A JSON document terminated by a newline character.
+     *   Binary: A frame starting with a zero byte, followed by the payload
+     *           size (four bytes, big endian) and a CBOR encoded request.
+     *
+     * In both formats, requests may span multiple packets and multiple
+     * requests may share a single packet. Binary frames transfer byte strings
+     * natively, which avoids the hex or base64 encoding of memory data.
+     * Binary frames are returned including the frame header.
+     */
+    string payload;
+
+    while (true) {
+
+        if (!inbox.empty() && inbox[0] == frameMarker) {
+
+            if (isize(inbox.size()) >= frameHeader) {
+
+                auto size = isize(u8(inbox[1]) << 24 | u8(inbox[2]) << 16 | u8(inbox[3]) << 8 | u8(inbox[4]));
+                if (size > maxRequestSize) throw ServerError(ServerError::SOCK_CANT_RECEIVE);
+
+                if (isize(inbox.size()) >= frameHeader + size) {
 
-    // Remove LF and CR (if present)
-    payload = utl::rtrim(payload, "\n\r");
+                    payload = inbox.substr(0, frameHeader + size);
+                    inbox.erase(0, frameHeader + size);
+                    break;
+                }
+            }
+
+        } else if (auto pos = inbox.find('\n'); pos != string::npos) {
+
+            // Remove CR (if present)
+            payload = utl::rtrim(inbox.substr(0, pos), "\r");
+            inbox.erase(0, pos + 1);
+            break;
+
+        } else if (isize(inbox.size()) > maxRequestSize) {
+
+            throw ServerError(ServerError::SOCK_CANT_RECEIVE);
+        }
+
+        inbox += connection.recv();
+    }
 
     if (config.verbose) {
 
@@ -73,54 +287,21 @@ RpcServer::doSend(const string &payload)
 void
 RpcServer::doProcess(const string &payload)
 {
-    try {
+    /* Requests are processed in the emulator thread, because most of them
+     * access the emulator state. The RetroShell bridge is dispatched from
+     * there, too, to keep the order of all incoming requests intact.
+     */
+    if (payload.empty()) return;
 
-        json request = json::parse(payload);
+    {   SYNCHRONIZED
 
-        // Check input format
-        if (!request.contains("method")) {
-            throw CoreError(RPC::INVALID_REQUEST, "Missing 'method'");
-        }
-        if (!request.contains("params")) {
-            throw CoreError(RPC::INVALID_REQUEST, "Missing 'params'");
-        }
-        if (!request["method"].is_string()) {
-            throw CoreError(RPC::INVALID_PARAMS, "'method' must be a string");
-        }
-        if (!request["params"].is_string()) {
-            throw CoreError(RPC::INVALID_PARAMS, "'params' must be a string");
-        }
-        if (request["method"] != "retroshell") {
-            throw CoreError(RPC::INVALID_PARAMS, "method  must be 'retroshell'");
-        }
-
-        // Feed the command into the command queue
-        retroShell.asyncExec(InputLine {
-
-            .id = request.value("id", 0),
-            .type = InputLine::Source::RPC,
-            .input = request["params"] });
-
-    } catch (const json::parse_error &) {
-
-        json response = {
-
-            {"jsonrpc", "2.0"},
-            {"error", {{"code", RPC::PARSE_ERROR}, {"message", "Parse error: " + payload}}},
-            {"id", nullptr}
-        };
-        send(response.dump());
-
-    } catch (const CoreError &e) {
+        pending.push_back(payload);
+    }
 
-        json response = {
+    emulator.put(Command(Cmd::RPC_EXECUTE));
 
-            {"jsonrpc", "2.0"},
-            {"error", {{"code", e.payload}, {"message", e.what()}}},
-            {"id", nullptr}
-        };
-        send(response.dump());
-    }
+    // Don't wait for the next timeout if the emulator is idle
+    if (!emulator.isRunning()) emulator.wakeUp();
 }
 
 void
@@ -175,4 +356,267 @@ RpcServer::didExecute(const InputLine& input, std::stringstream &ss, std::except
     send(response.dump());
 }
 
+void
+RpcServer::exec()
+{
+    std::vector<string> requests;
+    std::optional<ExecState> stateChange;
+
+    {   SYNCHRONIZED
+
+        std::swap(requests, pending);
+    }
+
+    for (auto &payload : requests) {
+
+        utl::TraceSpan trace("server", "RpcServer::exec");
+        json response;
+
+        bool binary = payload[0] == frameMarker;
+
+        try {
+
+            json request = binary ?
+            json::from_cbor(payload.begin() + frameHeader, payload.end()) :
+            json::parse(payload);
+
+            if (request.is_array()) {
+
+                // Process a batch of requests
+                if (request.empty()) throw RpcError(RPC::INVALID_REQUEST, "Empty batch");
+
+                response = json::array();
+                for (auto &it : request) response.push_back(process(it, true, binary, stateChange));
+
+            } else {
+
+                response = process(request, false, binary, stateChange);
+            }
+
+        } catch (const json::parse_error &) {
+
+            response = makeError(RPC::PARSE_ERROR, binary ? "Parse error" : "Parse error: " + payload, nullptr);
+
+        } catch (const RpcError &e) {
+
+            response = makeError(e.code, e.what(), nullptr);
+        }
+
+        // Requests to RetroShell are answered asynchronously
+        if (response.is_null()) continue;
+
+        if (binary) {
+
+            // Answer with a binary frame
+            auto cbor = json::to_cbor(response);
+            auto size = u32(cbor.size());
+
+            string frame = { frameMarker, char(size >> 24), char(size >> 16), char(size >> 8), char(size) };
+            frame.append(cbor.begin(), cbor.end());
+            send(frame);
+
+        } else {
+
+            send(response.dump());
+        }
+    }
+
+    // Serve a state change request that occurred while emulating frames
+    if (stateChange) emulator.switchState(*stateChange);
+}
+
+json
+RpcServer::process(const json &request, bool batched, bool binary, std::optional<ExecState> &stateChange)
+{
+    json id = request.is_object() ? request.value("id", json(nullptr)) : json(nullptr);
+
+    try {
+
+        // Check input format
+        if (!request.is_object()) {
+            throw RpcError(RPC::INVALID_REQUEST, "Request must be an object");
+        }
+        if (!request.contains("method")) {
+            throw RpcError(RPC::INVALID_REQUEST, "Missing 'method'");
+        }
+        if (!request["method"].is_string()) {
+            throw RpcError(RPC::INVALID_PARAMS, "'method' must be a string");
+        }
+
+        auto method = request["method"].get<string>();
+        auto params = request.value("params", json::object());
+
+        if (method == "retroshell") {
+
+            if (batched) {
+                throw RpcError(RPC::INVALID_REQUEST, "'retroshell' can't be part of a batch");
+            }
+            if (binary) {
+                throw RpcError(RPC::INVALID_REQUEST, "'retroshell' can't be sent in a binary frame");
+            }
+            if (!params.is_string()) {
+                throw RpcError(RPC::INVALID_PARAMS, "'params' must be a string");
+            }
+
+            // Feed the command into the command queue
+            retroShell.asyncExec(InputLine {
+
+                .id = request.value("id", 0),
+                .type = InputLine::Source::RPC,
+                .input = params });
+
+            return nullptr;
+        }
+
+        if (!params.is_object()) {
+            throw RpcError(RPC::INVALID_PARAMS, "'params' must be an object");
+        }
+
+        return {
+
+            {"jsonrpc", "2.0"},
+            {"result", call(method, params, binary, stateChange)},
+            {"id", id}
+        };
+
+    } catch (const RpcError &e) {
+
+        return makeError(e.code, e.what(), id);
+
+    } catch (const CoreError &e) {
+
+        return makeError(i64(e.fault()), e.what(), id);
+
+    } catch (const std::exception &e) {
+
+        return makeError(RPC::INTERNAL_ERROR, e.what(), id);
+    }
+}
+
+json
+RpcServer::call(const string &method, const json &params, bool binary, std::optional<ExecState> &stateChange)
+{
+    if (method == "mem.read") {
+
+        auto addr = u32(intArg(params, "addr"));
+        auto count = intArg(params, "count");
+        if (count < 0 || count > 0x100000) {
+            throw RpcError(RPC::INVALID_PARAMS, "'count' must be in range 0...0x100000");
+        }
+
+        std::vector<u8> data(count);
+        mem.spypeek<Accessor::CPU>(addr, count, data.data());
+        return encode(std::move(data), params, binary);
+    }
+
+    if (method == "mem.write") {
+
+        auto addr = u32(intArg(params, "addr"));
+        auto data = params.contains("data") && params["data"].is_binary() ?
+        std::vector<u8>(params["data"].get_binary()) :
+        decode(stringArg(params, "data"), useBase64(params));
+
+        mem.patch(addr, data.data(), isize(data.size()));
+        return data.size();
+    }
+
+    if (method == "cpu.get") {
+
+        json d = json::array(), a = json::array();
+        for (int i = 0; i < 8; i++) { d.push_back(cpu.getD(i)); a.push_back(cpu.getA(i)); }
+
+        return {
+
+            {"pc", cpu.getPC0()},
+            {"sr", cpu.getSR()},
+            {"usp", cpu.getUSP()},
+            {"isp", cpu.getISP()},
+            {"d", d},
+            {"a", a}
+        };
+    }
+
+    if (method == "cpu.set") {
+
+        for (auto &[key, value] : params.items()) {
+
+            if (!value.is_number_integer()) {
+                throw RpcError(RPC::INVALID_PARAMS, "'" + key + "' must be an integer");
+            }
+            auto val = value.get<u32>();
+
+            if (key.size() == 2 && key[0] == 'd' && key[1] >= '0' && key[1] <= '7') {
+                cpu.setD(key[1] - '0', val);
+            } else if (key.size() == 2 && key[0] == 'a' && key[1] >= '0' && key[1] <= '7') {
+                cpu.setA(key[1] - '0', val);
+            } else if (key == "pc") {
+                cpu.jump(val);
+            } else if (key == "sr") {
+                cpu.setSR(u16(val));
+            } else if (key == "usp") {
+                cpu.setUSP(val);
+            } else if (key == "isp") {
+                cpu.setISP(val);
+            } else {
+                throw RpcError(RPC::INVALID_PARAMS, "Unknown register '" + key + "'");
+            }
+        }
+        return true;
+    }
+
+    if (method == "emu.advance") {
+
+        auto frames = intArg(params, "frames", 1);
+        if (frames < 0) throw RpcError(RPC::INVALID_PARAMS, "'frames' must not be negative");
+        if (frames > maxAdvance) throw RpcError(RPC::INVALID_PARAMS, "'frames' must not exceed " + std::to_string(maxAdvance));
+        if (isPoweredOff()) throw RpcError(RPC::SERVER_ERROR, "The emulator is powered off");
+
+        // Don't emulate past a breakpoint hit by a previous request
+        if (!stateChange) {
+
+            try {
+                amiga.fastForward(frames);
+            } catch (const StateChangeException &exc) {
+                stateChange = ExecState(exc.payload);
+            }
+        }
+
+        return {
+
+            {"frame", agnus.pos.frame},
+            {"interrupted", stateChange.has_value()}
+        };
+    }
+
+    if (method == "input.key") {
+
+        auto code = intArg(params, "code");
+        if (code < 0 || code > 0x7F) throw RpcError(RPC::INVALID_PARAMS, "'code' must be in range 0...0x7F");
+
+        params.value("down", true) ? keyboard.press(KeyCode(code)) : keyboard.release(KeyCode(code));
+        return true;
+    }
+
+    if (method == "input.joystick") {
+
+        auto port = intArg(params, "port", 1);
+        if (port != 1 && port != 2) throw RpcError(RPC::INVALID_PARAMS, "'port' must be 1 or 2");
+
+        auto action = GamePadActionEnum::parseEnum(stringArg(params, "action"));
+        if (!action) throw RpcError(RPC::INVALID_PARAMS, GamePadActionEnum::keyList());
+
+        (port == 1 ? controlPort1 : controlPort2).joystick.trigger(*action);
+        return true;
+    }
+
+    if (method == "state.hash") {
+
+        char hash[32];
+        snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)amiga.checksum(true));
+        return hash;
+    }
+
+    throw RpcError(RPC::METHOD_NOT_FOUND, "Unknown method '" + method + "'");
+}
+
 }
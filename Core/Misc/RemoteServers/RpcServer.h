@@ -12,6 +12,7 @@
 #include "SocketServer.h"
 #include "RetroShellTypes.h"
 #include "Console.h"
+#include "json_fwd.h"
 
 namespace vamiga {
 
@@ -28,6 +29,21 @@ const long SERVER_ERROR     = -32000; // Reserved for implementation-defined ser
 
 class RpcServer final : public SocketServer, public ConsoleDelegate {
 
+    // First byte of a binary frame (never part of a text request)
+    static constexpr char frameMarker = 0;
+
+    // Size of the binary frame header (marker and payload size)
+    static constexpr isize frameHeader = 5;
+
+    // Maximum size of a single request
+    static constexpr isize maxRequestSize = 16 * 1024 * 1024;
+
+    // Received data not yet assembled to a complete request
+    string inbox;
+
+    // Requests waiting to be processed in the emulator thread
+    std::vector<string> pending;
+
 public:
 
     using SocketServer::SocketServer;
@@ -64,6 +80,7 @@ protected:
     void doProcess(const string &packet) override;
     void doSend(const string &packet)  override;
     void didStart() override;
+    void didConnect() override;
 
 
     //
@@ -73,6 +90,24 @@ protected:
     void willExecute(const InputLine &input) override;
     void didExecute(const InputLine &input, std::stringstream &ss) override;
     void didExecute(const InputLine &input, std::stringstream &ss, std::exception &e) override;
+
+
+    //
+    // Executing native methods
+    //
+
+public:
+
+    // Processes all pending requests (called by the emulator thread)
+    void exec();
+
+private:
+
+    // Processes a single request and returns the response
+    nlohmann::json process(const nlohmann::json &request, bool batched, bool binary, std::optional<ExecState> &stateChange);
+
+    // Executes a native method and returns the result
+    nlohmann::json call(const string &method, const nlohmann::json &params, bool binary, std::optional<ExecState> &stateChange);
 };
 
 }
@@ -193,6 +193,7 @@ SocketServer::send(std::stringstream &payload)
 void
 SocketServer::process(const string &payload)
 {
+    utl::TraceSpan trace("server", objectName());
     doProcess(payload);
 }
 
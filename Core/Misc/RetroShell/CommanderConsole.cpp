@@ -226,6 +226,18 @@ CommanderConsole::initCommands(RSCommand &root)
             amiga.regressionTester.dumpTexturePath = path;
         }
     });
+
+    root.add({
+
+        .tokens = { "screenshot", "set", "reference" },
+        .chelp  = { "Compare screenshots with the reference images in a folder" },
+        .args   = { { .name = { "path", "Folder path" } } },
+        .func   = [this] (std::ostream &os, const Arguments &args, const std::vector<isize> &values) {
+
+            auto path = host.makeAbsolute(args.at("path"));
+            amiga.regressionTester.referencePath = path;
+        }
+    });
     
     root.add({
         
@@ -1021,6 +1033,102 @@ CommanderConsole::initCommands(RSCommand &root)
     //
     
     cmd = registerComponent(logicAnalyzer);
+
+
+    //
+    // Miscellaneous (Stream exporter)
+    //
+
+    cmd = registerComponent(streamExporter);
+
+
+    //
+    // Miscellaneous (Recorder)
+    //
+
+    cmd = registerComponent(recorder);
+
+    root.add({
+
+        .tokens = { cmd, "start" },
+        .chelp  = { "Starts recording to <path>.y4m and <path>.wav" },
+        .args   = { { .name = { "path", "File path without extension" } } },
+        .func   = [this] (std::ostream &os, const Arguments &args, const std::vector<isize> &values) {
+
+            auto path = host.makeAbsolute(args.at("path"));
+            recorder.startRecording(path);
+        }
+    });
+
+    root.add({
+
+        .tokens = { cmd, "stop" },
+        .chelp  = { "Stops recording" },
+        .func   = [this] (std::ostream &os, const Arguments &args, const std::vector<isize> &values) {
+
+            recorder.stopRecording();
+        }
+    });
+
+    root.add({
+
+        .tokens = { cmd, "status" },
+        .chelp  = { "Displays the recorder status" },
+        .func   = [this] (std::ostream &os, const Arguments &args, const std::vector<isize> &values) {
+
+            dump(os, recorder, Category::State);
+        }
+    });
+
+
+    //
+    // Miscellaneous (Tracer)
+    //
+
+    root.add({
+
+        .tokens = { "trace" },
+        .ghelp  = { "Timeline tracer" },
+        .chelp  = { "Displays the number of recorded spans" },
+        .func   = [] (std::ostream &os, const Arguments &args, const std::vector<isize> &values) {
+
+            os << utl::tab("Tracing");
+            os << utl::bol(utl::Tracer::isTracing()) << std::endl;
+            os << utl::tab("Recorded spans");
+            os << utl::dec(utl::Tracer::count()) << std::endl;
+        }
+    });
+
+    root.add({
+
+        .tokens = { "trace", "start" },
+        .chelp  = { "Starts recording a timeline" },
+        .func   = [] (std::ostream &os, const Arguments &args, const std::vector<isize> &values) {
+
+            utl::Tracer::start();
+        }
+    });
+
+    root.add({
+
+        .tokens = { "trace", "stop" },
+        .chelp  = { "Stops recording" },
+        .func   = [] (std::ostream &os, const Arguments &args, const std::vector<isize> &values) {
+
+            utl::Tracer::stop();
+        }
+    });
+
+    root.add({
+
+        .tokens = { "trace", "save" },
+        .chelp  = { "Saves the timeline in Chrome trace-event format" },
+        .args   = { { .name = { "path", "File path" } } },
+        .func   = [this] (std::ostream &os, const Arguments &args, const std::vector<isize> &values) {
+
+            utl::Tracer::save(host.makeAbsolute(args.at("path")));
+        }
+    });
     
     
     //
@@ -1063,6 +1171,7 @@ CommanderConsole::initCommands(RSCommand &root)
     cmd = registerComponent(remoteManager.gdbServer);
     cmd = registerComponent(remoteManager.promServer);
     cmd = registerComponent(remoteManager.serServer);
+    cmd = registerComponent(remoteManager.frameServer);
 }
 
 }
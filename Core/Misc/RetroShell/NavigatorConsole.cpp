@@ -715,6 +715,9 @@ NavigatorConsole::initCommands(RSCommand &root)
                 vol = make_unique<Volume>(*adf);
                 fs  = make_unique<FileSystem>(*vol);
 
+                // Read blocks directly from the ADF
+                fs->setMapped(true);
+
                 fs->dumpInfo(os);
 
             }, .payload = {i}
@@ -822,7 +825,8 @@ NavigatorConsole::initCommands(RSCommand &root)
             .args   = {
                 { .name = { "file", "Export item" } },
                 { .name = { "path", "Host file system location" } },
-                { .name = { "r", "Export subdirectories" }, .flags = rs::flag }
+                { .name = { "r", "Export subdirectories" }, .flags = rs::flag },
+                { .name = { "p", "Preserve protection bits and dates" }, .flags = rs::flag }
             },
                 .func   = [this] (std::ostream &os, const Arguments &args, const std::vector<isize> &values) {
 
@@ -831,10 +835,11 @@ NavigatorConsole::initCommands(RSCommand &root)
                     auto itemNr = parsePath(args, "file");
                     bool recursive = args.contains("r");
                     bool contents = args.at("file").back() == '/';
-                    
+                    bool attributes = args.contains("p");
+
                     auto path = args.at("path");
                     auto hostPath = host.makeAbsolute(args.at("path"));
-                    fs->exporter.exportFiles(itemNr, hostPath, recursive, contents);
+                    fs->exporter.exportFiles(itemNr, hostPath, recursive, contents, attributes);
                 }
         });
     }
@@ -1385,6 +1390,7 @@ NavigatorConsole::initCommands(RSCommand &root)
             { .name = { "s", "Strict checking" }, .flags = rs::flag },
             { .name = { "v", "Verbose output" }, .flags = rs::flag },
             { .name = { "r", "Rectify errors" }, .flags = rs::flag },
+            { .name = { "threads", "Number of scanning threads (0 = auto)" }, .flags = rs::keyval|rs::opt },
             { .name = { "nr", "Block number" }, .flags = rs::opt }
         },
             .func   = [this] (std::ostream &os, const Arguments &args, const std::vector<isize> &values) {
@@ -1404,8 +1410,10 @@ NavigatorConsole::initCommands(RSCommand &root)
                     
                 } else {
                     
+                    auto threads = args.contains("threads") ? parseNum(args.at("threads")) : 1;
+
                     if (args.contains("r")) fs->doctor.rectify(strict);
-                    if (auto errors = fs->doctor.xray(strict, os, args.contains("v")); !errors) {
+                    if (auto errors = fs->doctor.xray(strict, os, args.contains("v"), threads); !errors) {
                         os << "No findings." << std::endl;
                     }
                 }
@@ -0,0 +1,291 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the Mozilla Public License v2
+//
+// See https://mozilla.org/MPL/2.0 for license information
+// -----------------------------------------------------------------------------
+
+#include "config.h"
+#include "StreamExporter.h"
+#include "Amiga.h"
+
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#define SHM_SUPPORT
+#endif
+
+namespace vamiga {
+
+StreamExporter::~StreamExporter()
+{
+    close();
+}
+
+void
+StreamExporter::_dump(Category category, std::ostream &os) const
+{
+    using namespace utl;
+
+    if (category == Category::Config) {
+
+        dumpConfig(os);
+    }
+
+    if (category == Category::State) {
+
+        os << tab("Shared memory");
+        os << (isActive() ? name : "not mapped") << std::endl;
+        os << tab("Segment size");
+        os << dec(segmentSize) << " Bytes" << std::endl;
+        os << tab("Exported frames");
+        os << dec(exportedFrames) << std::endl;
+        os << tab("Exported audio blocks");
+        os << dec(exportedBlocks) << std::endl;
+    }
+}
+
+i64
+StreamExporter::getOption(Opt option) const
+{
+    switch (option) {
+
+        case Opt::EXP_ENABLE:       return config.enable;
+        case Opt::EXP_FRAME_SLOTS:  return config.frameSlots;
+
+        default:
+            fatalError;
+    }
+}
+
+void
+StreamExporter::checkOption(Opt opt, i64 value)
+{
+    switch (opt) {
+
+        case Opt::EXP_ENABLE:
+
+#ifndef SHM_SUPPORT
+            if (value) throw CoreError(CoreError::OPT_UNSUPPORTED);
+#endif
+            return;
+
+        case Opt::EXP_FRAME_SLOTS:
+
+            if (value < 2 || value > 64) {
+                throw CoreError(CoreError::OPT_INV_ARG, "2...64");
+            }
+            return;
+
+        default:
+            throw CoreError(CoreError::OPT_UNSUPPORTED);
+    }
+}
+
+void
+StreamExporter::setOption(Opt option, i64 value)
+{
+    auto previous = config;
+
+    switch (option) {
+
+        case Opt::EXP_ENABLE:
+
+            config.enable = bool(value);
+            break;
+
+        case Opt::EXP_FRAME_SLOTS:
+
+            config.frameSlots = isize(value);
+            break;
+
+        default:
+            fatalError;
+    }
+
+    // Recreate the shared memory segment with the new settings
+    close();
+
+    try {
+
+        if (config.enable) open();
+
+    } catch (...) {
+
+        // Keep the previous settings and the previous segment (if possible)
+        config = previous;
+        try { if (config.enable) open(); } catch (...) { config.enable = false; }
+        throw;
+    }
+}
+
+void
+StreamExporter::open()
+{
+    assert(!isActive());
+
+    // Only the main instance exports data
+    if (isRunAheadInstance()) return;
+
+#ifdef SHM_SUPPORT
+
+    static std::atomic<isize> counter = 0;
+
+    auto align = [](isize size) { return (size + 63) & ~63; };
+
+    auto frameSlotSize = align(isize(sizeof(ShmFrameSlot)) + PIXELS * isize(sizeof(Texel)));
+    auto audioSlotSize = align(isize(sizeof(ShmAudioSlot)) + audioCapacity * isize(sizeof(SamplePair)));
+    auto frameOffset = align(sizeof(ShmHeader));
+    auto audioOffset = frameOffset + config.frameSlots * frameSlotSize;
+    auto size = audioOffset + audioSlots * audioSlotSize;
+
+    // Create a segment with a unique name
+    auto shmName = "/vAmiga." + std::to_string(getpid()) + "." + std::to_string(counter++);
+
+    auto fd = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) throw IOError(IOError::FILE_CANT_CREATE, shmName);
+
+    if (ftruncate(fd, off_t(size)) != 0) {
+
+        ::close(fd);
+        shm_unlink(shmName.c_str());
+        throw IOError(IOError::FILE_CANT_CREATE, shmName);
+    }
+
+    auto ptr = mmap(nullptr, size_t(size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (ptr == MAP_FAILED) {
+
+        shm_unlink(shmName.c_str());
+        throw IOError(IOError::FILE_CANT_CREATE, shmName);
+    }
+
+    name = shmName;
+    segment = (u8 *)ptr;
+    segmentSize = size;
+    exportedFrames = 0;
+    exportedBlocks = 0;
+
+    // Setup the segment header (the rest of the segment is zero-initialized)
+    auto &hdr = *new (segment) ShmHeader { };
+    hdr.version = SHM_VERSION;
+    hdr.pid = u32(getpid());
+    hdr.frameSlots = u32(config.frameSlots);
+    hdr.frameWidth = u32(HPIXELS);
+    hdr.frameHeight = u32(VPIXELS);
+    hdr.texelSize = u32(sizeof(Texel));
+    hdr.frameSlotSize = u32(frameSlotSize);
+    hdr.frameOffset = u64(frameOffset);
+    hdr.audioSlots = u32(audioSlots);
+    hdr.audioCapacity = u32(audioCapacity);
+    hdr.audioSlotSize = u32(audioSlotSize);
+    hdr.sampleRate = u32(audioPort.getSampleRate());
+    hdr.audioOffset = u64(audioOffset);
+
+    // Signal readers that the segment is ready
+    std::atomic_thread_fence(std::memory_order_release);
+    hdr.magic = SHM_MAGIC;
+
+#else
+
+    throw CoreError(CoreError::OPT_UNSUPPORTED);
+
+#endif
+}
+
+void
+StreamExporter::close()
+{
+#ifdef SHM_SUPPORT
+
+    if (isActive()) {
+
+        munmap(segment, size_t(segmentSize));
+        shm_unlink(name.c_str());
+    }
+
+#endif
+
+    segment = nullptr;
+    segmentSize = 0;
+    name.clear();
+}
+
+void
+StreamExporter::exportFrame(const Texture &texture)
+{
+    if (!isActive()) return;
+
+    auto &hdr = header();
+    auto n = hdr.frameSeq.load(std::memory_order_relaxed) + 1;
+    auto &slot = *(ShmFrameSlot *)(segment + hdr.frameOffset + ((n - 1) % hdr.frameSlots) * hdr.frameSlotSize);
+
+    // Lock the slot
+    slot.seq.store(2 * n - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.nr = texture.nr;
+    slot.lof = texture.lof;
+    slot.prevlof = texture.prevlof;
+    std::memcpy((u8 *)(&slot + 1), texture.pixels.ptr, PIXELS * sizeof(Texel));
+
+    // Unlock the slot and publish it
+    slot.seq.store(2 * n, std::memory_order_release);
+    hdr.frameSeq.store(n, std::memory_order_release);
+
+    exportedFrames++;
+}
+
+void
+StreamExporter::exportAudio(const AudioStream &stream, isize count)
+{
+    if (!isActive()) return;
+
+    auto &hdr = header();
+
+    // The slot being filled (opened when the first sample arrives)
+    ShmAudioSlot *slot = nullptr;
+    SamplePair *samples = nullptr;
+    isize chunk = 0;
+    u64 n = 0;
+
+    auto publish = [&]() {
+
+        slot->count = u32(chunk);
+
+        // Unlock the slot and publish it
+        slot->seq.store(2 * n, std::memory_order_release);
+        hdr.audioSeq.store(n, std::memory_order_release);
+
+        exportedBlocks++;
+        slot = nullptr;
+    };
+
+    stream.copyLatest(count, [&](const SamplePair &sample) {
+
+        if (!slot) {
+
+            n = hdr.audioSeq.load(std::memory_order_relaxed) + 1;
+            slot = (ShmAudioSlot *)(segment + hdr.audioOffset + ((n - 1) % hdr.audioSlots) * hdr.audioSlotSize);
+            samples = (SamplePair *)(slot + 1);
+            chunk = 0;
+
+            // Lock the slot
+            slot->seq.store(2 * n - 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            slot->frame = agnus.pos.frame;
+        }
+
+        samples[chunk++] = sample;
+        if (chunk == audioCapacity) publish();
+    });
+
+    if (slot) publish();
+}
+
+}
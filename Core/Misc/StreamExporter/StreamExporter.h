@@ -0,0 +1,149 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the Mozilla Public License v2
+//
+// See https://mozilla.org/MPL/2.0 for license information
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "StreamExporterTypes.h"
+#include "SubComponent.h"
+
+namespace vamiga {
+
+/* The stream exporter publishes the emulator output in a POSIX shared memory
+ * segment. Each completed frame and each synthesized block of audio samples
+ * is written into a ring buffer, together with a sequence number. External
+ * tools such as video encoders can map the segment and consume the data
+ * without interfering with the emulator thread (see StreamExporterTypes.h
+ * for the reader protocol).
+ */
+class StreamExporter final : public SubComponent {
+
+    Descriptions descriptions = {{
+
+        .type           = Class::StreamExporter,
+        .name           = "Exporter",
+        .description    = "Stream Exporter",
+        .shell          = "exporter"
+    }};
+
+    Options options = {
+
+        Opt::EXP_ENABLE,
+        Opt::EXP_FRAME_SLOTS
+    };
+
+    // Number of slots in the audio ring
+    static constexpr isize audioSlots = 64;
+
+    // Maximum number of sample pairs in a single audio block
+    static constexpr isize audioCapacity = 2048;
+
+    // Current configuration
+    StreamExporterConfig config = { };
+
+    // Name of the shared memory segment
+    string name;
+
+    // The mapped shared memory segment
+    u8 *segment = nullptr;
+    isize segmentSize = 0;
+
+    // Statistics
+    i64 exportedFrames = 0;
+    i64 exportedBlocks = 0;
+
+
+    //
+    // Constructing
+    //
+
+public:
+
+    using SubComponent::SubComponent;
+    ~StreamExporter();
+
+    StreamExporter& operator= (const StreamExporter& other) {
+
+        return *this;
+    }
+
+
+    //
+    // Methods from CoreObject
+    //
+
+private:
+
+    void _dump(Category category, std::ostream &os) const override;
+
+
+    //
+    // Methods from CoreComponent
+    //
+
+public:
+
+    const Descriptions &getDescriptions() const override { return descriptions; }
+
+
+    //
+    // Serializing
+    //
+
+    template <class T> void serialize(T& worker) { } SERIALIZERS(serialize);
+
+
+    //
+    // Methods from Configurable
+    //
+
+public:
+
+    const StreamExporterConfig &getConfig() const { return config; }
+    const Options &getOptions() const override { return options; }
+    i64 getOption(Opt option) const override;
+    void checkOption(Opt opt, i64 value) override;
+    void setOption(Opt option, i64 value) override;
+
+
+    //
+    // Managing the shared memory segment
+    //
+
+public:
+
+    // Returns the name of the shared memory segment (empty if inactive)
+    const string &getName() const { return name; }
+
+    // Indicates whether data is currently exported
+    bool isActive() const { return segment != nullptr; }
+
+private:
+
+    void open();
+    void close();
+
+
+    //
+    // Exporting
+    //
+
+public:
+
+    // Publishes a completed frame
+    void exportFrame(const class Texture &texture);
+
+    // Publishes the most recently synthesized audio samples
+    void exportAudio(const class AudioStream &stream, isize count);
+
+private:
+
+    ShmHeader &header() const { return *(ShmHeader *)segment; }
+};
+
+}
@@ -0,0 +1,124 @@
+// -----------------------------------------------------------------------------
+// This file is part of vAmiga
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the Mozilla Public License v2
+//
+// See https://mozilla.org/MPL/2.0 for license information
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "BasicTypes.h"
+#include <atomic>
+
+namespace vamiga {
+
+//
+// Structures
+//
+
+typedef struct
+{
+    // Indicates whether frames and audio are published in shared memory
+    bool enable;
+
+    // Number of slots in the frame ring
+    isize frameSlots;
+}
+StreamExporterConfig;
+
+
+//
+// Shared memory layout
+//
+
+/* The shared memory segment starts with a header, followed by the frame ring
+ * and the audio ring. Each ring is an array of equally sized slots. A slot
+ * starts with a slot header which is followed by the payload (texels or
+ * sample pairs).
+ *
+ * Readers never block the emulator. Each slot is guarded by a sequence lock:
+ *
+ *  1. Read the sequence counter n from the segment header (n = 0 means
+ *     that nothing has been published yet). The latest item resides in slot
+ *     (n - 1) % slots.
+ *  2. Read the slot's sequence number s1. If s1 != 2 * n, the slot has
+ *     already been reused and the reader should start over.
+ *  3. Read the payload (in place or by copying it).
+ *  4. Read the slot's sequence number s2. If s1 == s2, the payload is valid.
+ *     Otherwise, the writer has overwritten the slot in the meantime.
+ *
+ * Older items can be accessed the same way, as long as they have not been
+ * overwritten. Item k (1 <= k <= n) resides in slot (k - 1) % slots and is
+ * valid iff the sequence number of this slot equals 2 * k.
+ */
+
+static constexpr u32 SHM_MAGIC   = 0x56414D58; // "VAMX"
+static constexpr u32 SHM_VERSION = 1;
+
+typedef struct
+{
+    // Magic bytes and layout version
+    u32 magic;
+    u32 version;
+
+    // Process id of the writer
+    u32 pid;
+
+    // Frame ring properties
+    u32 frameSlots;
+    u32 frameWidth;
+    u32 frameHeight;
+    u32 texelSize;
+    u32 frameSlotSize;
+    u64 frameOffset;
+
+    // Audio ring properties
+    u32 audioSlots;
+    u32 audioCapacity;
+    u32 audioSlotSize;
+    u32 sampleRate;
+    u64 audioOffset;
+
+    // Number of published frames and audio blocks
+    std::atomic<u64> frameSeq;
+    std::atomic<u64> audioSeq;
+}
+ShmHeader;
+
+typedef struct
+{
+    // Sequence lock (odd while the slot is being written)
+    std::atomic<u64> seq;
+
+    // Frame number
+    i64 nr;
+
+    // Long frame bits of this frame and the previous one
+    u32 lof;
+    u32 prevlof;
+
+    // Texel data follows...
+}
+ShmFrameSlot;
+
+typedef struct
+{
+    // Sequence lock (odd while the slot is being written)
+    std::atomic<u64> seq;
+
+    // Number of the frame the samples belong to
+    i64 frame;
+
+    // Number of stored sample pairs
+    u32 count;
+    u32 padding;
+
+    // Sample pairs (left and right channel as float) follow...
+}
+ShmAudioSlot;
+
+static_assert(std::atomic<u64>::is_always_lock_free);
+
+}
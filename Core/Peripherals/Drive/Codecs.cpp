@@ -248,7 +248,7 @@ Codec::decodeEADF(EADFFile &eadf, const FloppyDisk &disk)
         auto bytes = disk.track[t].size() / 8;
 
         for (isize i = 0; i < bytes; i++, p++) {
-            *p = disk.data.track[t][i];
+            *p = disk.data[t]->ptr[i];
         }
     }
 
@@ -289,7 +289,8 @@ Codec::decodeST(class STFile &target, const FloppyDisk &disk)
 void
 Codec::encodeDMS(const class DMSFile &source, FloppyDisk &disk)
 {
-    disk.encode(source.getADF());
+    // Encode track by track to only unpack what is needed for each track
+    disk.encodeDisk(source);
 }
 
 void
@@ -59,6 +59,9 @@ public:
     virtual bool hasModifiedDisk() const = 0;
     virtual bool hasProtectedDisk() const = 0;
 
+    // Returns a hash value of the disk contents (0 if no disk is inserted)
+    virtual u64 diskFingerprint() const = 0;
+
     // Gets or sets a disk flag
     virtual bool getFlag(DiskFlags mask) const = 0;
     virtual void setFlag(DiskFlags mask, bool value) = 0;
@@ -43,7 +43,8 @@ FloppyDisk::init(Diameter dia, Density den, bool wp)
 
     for (isize i = 0; i < 168; i++) {
 
-        track[i] = MutableBitView(data.track[i], numTrackBytes * 8);
+        data[i] = std::make_shared<Buffer<u8>>(numTrackBytes);
+        track[i] = MutableBitView(data[i]->ptr, numTrackBytes * 8);
     }
     clearDisk();
     setWriteProtection(wp);
@@ -156,6 +157,7 @@ FloppyDisk::writeBlock(const u8 *src, isize nr)
     if (!sector.has_value())
         throw IOError(DeviceError::SEEK_ERR, "Block " + std::to_string(nr));
 
+    detach(t);
     auto tr = track[t];
     auto it = track[t].cyclic_begin() + sector->lower;
 
@@ -208,7 +210,7 @@ FloppyDisk::checksum() const
 u64
 FloppyDisk::checksum(TrackNr t) const
 {
-    return Hashable::fnv64(data.track[t], track[t].size() / 8);
+    return Hashable::fnv64(data[t]->ptr, track[t].size() / 8);
 }
 
 u64
@@ -220,49 +222,53 @@ FloppyDisk::checksum(CylNr c, HeadNr h) const
 BitView
 FloppyDisk::bitView(TrackNr t) const
 {
-    return BitView(data.track[t], track[t].size());
+    return BitView(data[t]->ptr, track[t].size());
 }
 
 BitView
 FloppyDisk::bitView(TrackNr t, SectorNr s) const
 {
-    return BitView(data.track[t] + s * 1088 * 8, 1088 * 8);
+    return BitView(data[t]->ptr + s * 1088, 1088 * 8);
 }
 
 MutableBitView
 FloppyDisk::bitView(TrackNr t)
 {
-    return MutableBitView(data.track[t], track[t].size());
+    detach(t);
+    return MutableBitView(data[t]->ptr, track[t].size());
 }
 
 MutableBitView
 FloppyDisk::bitView(TrackNr t, SectorNr s)
 {
-    return MutableBitView(data.track[t] + s * 1088 * 8, 1088 * 8);
+    detach(t);
+    return MutableBitView(data[t]->ptr + s * 1088, 1088 * 8);
 }
 
 ByteView
 FloppyDisk::byteView(TrackNr t) const
 {
-    return ByteView(data.track[t], track[t].size() / 8);
+    return ByteView(data[t]->ptr, track[t].size() / 8);
 }
 
 ByteView
 FloppyDisk::byteView(TrackNr t, SectorNr s) const
 {
-    return ByteView(data.track[t] + s * 1088, 1088);
+    return ByteView(data[t]->ptr + s * 1088, 1088);
 }
 
 MutableByteView
 FloppyDisk::byteView(TrackNr t)
 {
-    return MutableByteView(data.track[t], track[t].size() / 8);
+    detach(t);
+    return MutableByteView(data[t]->ptr, track[t].size() / 8);
 }
 
 MutableByteView
 FloppyDisk::byteView(TrackNr t, SectorNr s)
 {
-    return MutableByteView(data.track[t] + s * 1088, 1088);
+    detach(t);
+    return MutableByteView(data[t]->ptr + s * 1088, 1088);
 }
 
 u8
@@ -284,6 +290,7 @@ FloppyDisk::write8(CylNr c, HeadNr h, isize offset, u8 value)
     assert(t >= 0 && t < numTracks());
     assert(offset >= 0 && offset < track[t].size());
 
+    detach(t);
     track[t].setByte(offset, value);
     setModified(true);
 }
@@ -293,20 +300,29 @@ FloppyDisk::clearDisk()
 {
     setModified(force::DISK_MODIFIED);
 
-    // Initialize with random data
+    /* Initialize with random data. The random stream is consumed as if all
+     * tracks were 32 KB in size to keep the contents of unformatted tracks
+     * independent of the actual track lengths.
+     */
     srand(0);
-    for (usize i = 0; i < sizeof(data.raw); i++) {
-        data.raw[i] = rand() & 0xFF;
+    for (isize t = 0; t < 168; t++) {
+
+        detach(t);
+        for (isize i = 0; i < 32768; i++) {
+
+            auto value = u8(rand() & 0xFF);
+            if (i < data[t]->size) data[t]->ptr[i] = value;
+        }
     }
-    
+
     /* In order to make some copy protected game titles work, we smuggle in
      * some magic values. E.g., Crunch factory expects 0x44A2 on cylinder 80.
      */
     if (diameter == Diameter::INCH_35 && density == Density::DD) {
         
         for (isize t = 0; t < numTracks(); t++) {
-            data.track[t][0] = 0x44;
-            data.track[t][1] = 0xA2;
+            data[t]->ptr[0] = 0x44;
+            data[t]->ptr[1] = 0xA2;
         }
     }
 }
@@ -314,9 +330,7 @@ FloppyDisk::clearDisk()
 void
 FloppyDisk::clearDisk(u8 value)
 {
-    for (usize i = 0; i < sizeof(data.raw); i++) {
-        data.raw[i] = value;
-    }
+    for (isize t = 0; t < 168; t++) clearTrack(t, value);
 }
 
 void
@@ -324,20 +338,21 @@ FloppyDisk::clearTrack(TrackNr t)
 {
     assert(t < numTracks());
 
+    detach(t);
+
     srand(0);
-    for (usize i = 0; i < sizeof(data.track[t]); ++i) {
-        data.track[t][i] = rand() & 0xFF;
+    for (isize i = 0; i < data[t]->size; ++i) {
+        data[t]->ptr[i] = rand() & 0xFF;
     }
 }
 
 void
 FloppyDisk::clearTrack(TrackNr t, u8 value)
 {
-    assert(t < numTracks());
+    assert(t < 168);
 
-    for (usize i = 0; i < sizeof(data.track[t]); ++i) {
-        data.track[t][i] = value;
-    }
+    detach(t);
+    data[t]->clear(value);
 }
 
 void
@@ -345,8 +360,19 @@ FloppyDisk::clearTrack(TrackNr t, u8 value1, u8 value2)
 {
     assert(t < numTracks());
 
-    for (usize i = 0; i < sizeof(data.track[t]); ++i) {
-        data.track[t][i] = IS_ODD(i) ? value2 : value1;
+    detach(t);
+    for (isize i = 0; i < data[t]->size; ++i) {
+        data[t]->ptr[i] = IS_ODD(i) ? value2 : value1;
+    }
+}
+
+void
+FloppyDisk::detach(TrackNr t)
+{
+    if (data[t].use_count() > 1) {
+
+        data[t] = std::make_shared<Buffer<u8>>(*data[t]);
+        track[t] = MutableBitView(data[t]->ptr, track[t].size());
     }
 }
 
@@ -558,15 +584,13 @@ void
 FloppyDisk::replaceTrack(TrackNr t, BitView mfm)
 {
     auto numBits  = mfm.size();
-    auto numBytes = mfm.bytes().size();
-
-    assert(numBytes < sizeof(data.track[t]));
+    auto numBytes = isize(mfm.bytes().size());
 
-    // Copy track data
-    memcpy(data.track[t], mfm.data(), numBytes);
+    assert(numBytes < 32768);
 
-    // Adapt the new length
-    track[t] = MutableBitView(track[t].data(), numBits);
+    // Replace the track buffer
+    data[t] = std::make_shared<Buffer<u8>>(mfm.data(), numBytes);
+    track[t] = MutableBitView(data[t]->ptr, numBits);
 }
 
 void
@@ -582,9 +606,10 @@ FloppyDisk::shiftTracks(isize offset)
         assert(track[t].size() % 8 == 0);
 
         isize len = track[t].size() / 8;
-        memcpy(spare, data.track[t], len);
-        memcpy(spare + len, data.track[t], len);
-        memcpy(data.track[t], spare + (len + t * offset) % len, len);
+        detach(t);
+        memcpy(spare, data[t]->ptr, len);
+        memcpy(spare + len, data[t]->ptr, len);
+        memcpy(data[t]->ptr, spare + (len + t * offset) % len, len);
     }
 }
 
@@ -628,7 +653,7 @@ FloppyDisk::readTrackBits(TrackNr t) const
 
     for (isize i = 0; i < track[t].size() / 8; i++) {
         for (isize j = 7; j >= 0; j--) {
-            result += GET_BIT(data.track[t][i], j) ? '1' : '0';
+            result += GET_BIT(data[t]->ptr[i], j) ? '1' : '0';
         }
     }
     
@@ -85,12 +85,11 @@ public:
     
 private:
     
-    // The MFM encoded disk data
-    union {
-        u8 raw[168*32768];
-        u8 cylinder[84][2][32768];
-        u8 track[168][32768];
-    } data;
+    /* The MFM encoded disk data. Each track is stored in a separate buffer
+     * matching its actual length. Buffers are shared among cloned disks
+     * (e.g., the disks of the run-ahead instance) and copied on write.
+     */
+    std::shared_ptr<Buffer<u8>> data[168];
 
     // Bit views on top of the disk data
     MutableBitView track[168] {};
@@ -126,13 +125,10 @@ public:
 
         CLONE(diameter)
         CLONE(density)
-        CLONE_ARRAY(data.raw)
+        CLONE_ARRAY(data)
+        CLONE_ARRAY(track)
         CLONE(flags)
 
-        for (isize i = 0; i < 168; ++i) {
-            track[i] = MutableBitView(track[i].data(), other.track[i].size());
-        }
-
         return *this;
     }
 
@@ -198,8 +194,14 @@ private:
 
         << diameter
         << density
-        << data.raw
         << flags;
+
+        for (isize t = 0; t < 168; ++t) {
+
+            i64 numBits = track[t].size();
+            worker << numBits << MediaRef { *data[t] };
+            track[t] = MutableBitView(data[t]->ptr, numBits);
+        }
     };
 
     //
@@ -276,6 +278,11 @@ public:
     void clearTrack(TrackNr t);
     void clearTrack(TrackNr t, u8 value);
     void clearTrack(TrackNr t, u8 value1, u8 value2);
+
+private:
+
+    // Provides a private copy of a track buffer that is shared with a clone
+    void detach(TrackNr t);
     
     
     //
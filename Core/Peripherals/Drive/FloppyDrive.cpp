@@ -429,6 +429,12 @@ FloppyDrive::hasDisk() const
     return disk != nullptr;
 }
 
+u64
+FloppyDrive::diskFingerprint() const
+{
+    return disk ? Hashable::fnvIt64(disk->checksum(), disk->isWriteProtected()) : 0;
+}
+
 bool
 FloppyDrive::hasModifiedDisk() const
 {
@@ -753,6 +759,9 @@ FloppyDrive::setMotor(bool value)
     
     // Reset the identification bit counter if motor has been turned off
     idCount = 0;
+
+    // Record a pending boot state when DF0 is accessed for the first time
+    if (value && objid == 0 && amiga.awaitsBootState()) amiga.setFlag(RL::BOOT_STATE);
     
     // Inform the GUI
     msgQueue.put(Msg::DRIVE_LED, DriveMsg { i16(objid), value, 0, 0 });
@@ -1222,7 +1231,7 @@ FloppyDrive::insertNew(FSFormat dos, BootBlockId bb, string name, const fs::path
     fs.format(dos);
 
     // If a path is given, import files
-    if (!path.empty()) fs.importer.import(path);
+    if (!path.empty()) fs.importer.importBulk(path);
 
     // Create a file system and import the directory
     // auto dev = make_unique<Device>(GeometryDescriptor(diameter(), density()));
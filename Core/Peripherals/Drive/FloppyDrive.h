@@ -240,6 +240,7 @@ public:
 
     bool hasDisk() const override;
     bool hasModifiedDisk() const override;
+    u64 diskFingerprint() const override;
     bool hasProtectedDisk() const override;
 
     bool getFlag(DiskFlags mask) const override;
@@ -50,6 +50,8 @@ HardDrive::operator= (const HardDrive& other) {
     CLONE(state)
     CLONE(flags)
 
+    dataHash = 0;
+
     if constexpr (debug::RUA_ON_STEROIDS) {
 
         // Clone all blocks
@@ -77,6 +79,7 @@ HardDrive::init()
 {
     data.dealloc();
     dirty.dealloc();
+    dataHash = 0;
 
     diskVendor = "VAMIGA";
     diskProduct = "VDRIVE";
@@ -316,6 +319,7 @@ HardDrive::connect()
         init(MB(10));
         format(amiga::FSFormat::OFS, FSName(defaultName()));
         setFlag(DiskFlags::BOOTABLE, false);
+        defaultDiskHash = dataHash = data.fnv64();
     }
 }
 
@@ -384,6 +388,7 @@ HardDrive::_didLoad()
 {
     // Mark all blocks as dirty
     dirty.clear(true);
+    dataHash = 0;
 }
 
 void
@@ -475,6 +480,7 @@ HardDrive::write(const u8 *src, isize offset, isize count)
 {
     assert(offset + count <= data.size);
     memcpy((void *)(data.ptr + offset), (void *)src, count);
+    dataHash = 0;
 }
 
 bool
@@ -489,6 +495,21 @@ HardDrive::hasDisk() const
     return data.ptr != nullptr;
 }
 
+u64
+HardDrive::diskFingerprint() const
+{
+    if (!hasDisk()) return 0;
+
+    // Hashing the disk data is expensive. Hence, the hash value is cached.
+    if (!dataHash) dataHash = data.fnv64();
+    auto hash = dataHash;
+
+    // The default disk carries a creation date. Identify it by its size only.
+    if (hash == defaultDiskHash) hash = Hashable::fnvIt64(Hashable::fnvInit64(), data.size);
+
+    return Hashable::fnvIt64(hash, hasProtectedDisk());
+}
+
 bool 
 HardDrive::getFlag(DiskFlags mask) const
 {
@@ -639,7 +660,8 @@ HardDrive::write(isize offset, isize length, u32 addr)
 
             // Perform the write operation
             mem.spypeek <Accessor::CPU> (addr, length, data.ptr + offset);
-            
+            dataHash = 0;
+
             // Mark disk as modified
             setFlag(DiskFlags::MODIFIED, true);
         }
@@ -755,7 +777,7 @@ HardDrive::importFolder(const fs::path &path)
         auto fs = FileSystem(vol);
 
         // Import all files
-        fs.importer.import(fs.root(), path, true, true);
+        fs.importer.importBulk(fs.root(), path, true, true);
         
         // Write back
         fs.flush();
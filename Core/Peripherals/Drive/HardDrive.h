@@ -113,6 +113,12 @@ private:
     // Disk state flags
     long flags = 0;
 
+    // Hash value of the default disk created in connect() (0 = none)
+    u64 defaultDiskHash = 0;
+
+    // Hash value of the disk data (0 = needs to be recomputed)
+    mutable u64 dataHash = 0;
+
     
     //
     // Initializing
@@ -247,7 +253,7 @@ private:
         << geometry
         << ptable
         << drivers
-        << data
+        << MediaRef { data }
         << flags;
 
     } SERIALIZERS(serialize);
@@ -284,6 +290,7 @@ public:
 
     bool hasDisk() const override;
     bool hasModifiedDisk() const override;
+    u64 diskFingerprint() const override;
     bool hasProtectedDisk() const override;
     void setModificationFlag(bool value) override;
     void setProtectionFlag(bool value) override;
@@ -357,6 +357,8 @@ AudioPort::synthesize(Cycle clock, Cycle target)
     // Do not synthesize anything if this is the run-ahead instance
     if (amiga.objid != 0) return;
 
+    utl::TraceSpan trace("audio", "synthesize");
+
     // Run the ASR algorithm (adaptive sample rate)
     if (config.asr) { updateSampleRateCorrection(); } else { sampleRateCorrection = 0.0; }
     
@@ -371,6 +373,10 @@ AudioPort::synthesize(Cycle clock, Cycle target)
     
     // Synthesize samples
     synthesize(clock, (long)count, cps);
+
+    // Publish the new samples
+    if (streamExporter.isActive()) streamExporter.exportAudio(stream, isize(count));
+    if (recorder.isRecording()) recorder.recordAudio(stream);
 }
 
 void
@@ -400,7 +406,8 @@ AudioPort::synthesize(Cycle clock, long count, double cyclesPerSample)
     // Send the MUTE message if needed
     if (muted != wasMuted) { msgQueue.put(Msg::MUTE, wasMuted = muted); }
 
-    stream.mutex.lock();
+    // Refill the buffer with silence if the consumer has run out of samples
+    stream.alignIfRequested();
 
     // Check for a buffer overflow
     if (stream.free() < count) handleBufferOverflow();
@@ -413,19 +420,17 @@ AudioPort::synthesize(Cycle clock, long count, double cyclesPerSample)
             // Fill with zeroes
             for (isize i = 0; i < count; i++) stream.write( SamplePair { 0, 0 } );
             stats.idleSamples += count;
-            stream.mutex.unlock();
             return;
         }
         if (!sampler[0].isActive() && !sampler[1].isActive() &&
             !sampler[2].isActive() && !sampler[3].isActive()) {
 
             // Copy zeroes if nothing can be heared any more
-            auto latest = stream.isEmpty() ? SamplePair{} : stream.latest();
+            auto latest = stream.latest();
             if (std::abs(latest.l) + std::abs(latest.r) < 1e-8) {
                 
                 for (isize i = 0; i < count; i++) stream.write(SamplePair{});
                 stats.idleSamples += count;
-                stream.mutex.unlock();
                 return;
             }
         }
@@ -441,8 +446,6 @@ AudioPort::synthesize(Cycle clock, long count, double cyclesPerSample)
         default:
             fatalError;
     }
-
-    stream.mutex.unlock();
 }
 
 template <SamplingMethod method> void
@@ -489,7 +492,7 @@ AudioPort::synthesize(Cycle clock, long count, double cyclesPerSample)
         assert(std::abs(r) < 1.0);
 
         // Write sample into ringbuffer
-        stream.put( SamplePair { float(l), float(r) } );
+        stream.write( SamplePair { float(l), float(r) } );
 
         cycle += cyclesPerSample;
     }
@@ -500,9 +503,8 @@ AudioPort::synthesize(Cycle clock, long count, double cyclesPerSample)
 void
 AudioPort::handleBufferUnderflow()
 {
-    // Wipe out the buffer and reset the write pointer
-    stream.clear(SamplePair{0,0});
-    stream.alignWritePtr();
+    // Ask the emulator thread to refill the buffer with silence
+    stream.requestAlignment();
 
     // Determine the elapsed seconds since the last pointer adjustment
     auto elapsedTime = utl::Time::now() - lastAlignment;
@@ -225,6 +225,7 @@ public:
     void setOption(Opt option, i64 value) override;
 
     void setSampleRate(double hz);
+    double getSampleRate() const { return sampleRate; }
 
     
     //
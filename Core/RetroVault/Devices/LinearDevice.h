@@ -36,6 +36,9 @@ public:
     // Writes a sequence of bytes starting at byte offset
     virtual void write(const u8 *src, isize offset, isize count) = 0;
 
+    // Returns the device memory if the device is backed by memory (or nullptr)
+    virtual const u8 *map() const { return nullptr; }
+
     // Reads a single byte
     virtual u8 readByte(isize offset) const;
 
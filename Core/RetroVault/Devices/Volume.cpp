@@ -43,6 +43,13 @@ Volume::write(const u8 *src, isize offset, isize count)
     device.write(src, range.translate(0) * bsize() + offset, count);
 }
 
+const u8 *
+Volume::map() const
+{
+    auto *mem = device.map();
+    return mem ? mem + range.translate(0) * bsize() : nullptr;
+}
+
 void
 Volume::readBlocks(u8 *dst, Range<isize> r) const
 {
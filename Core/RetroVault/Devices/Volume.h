@@ -52,6 +52,7 @@ public:
     isize size() const override { return capacity() * bsize(); }
     void read(u8 *dst, isize offset, isize count) const override;
     void write(const u8 *src, isize offset, isize count) override;
+    const u8 *map() const override;
 
     
     //
@@ -56,6 +56,8 @@ FSAllocator::requiredBlocks(isize fileSize) const noexcept
 bool
 FSAllocator::allocatable(isize count) const noexcept
 {
+    if (ensureIndex()) return freeCount >= count;
+
     BlockNr i = ap;
     isize capacity = fs.blocks();
 
@@ -72,24 +74,78 @@ FSAllocator::allocatable(isize count) const noexcept
     return true;
 }
 
-BlockNr
-FSAllocator::allocate()
+void
+FSAllocator::locateFree(isize count, std::vector<BlockNr> &result) const
 {
+    if (count <= 0) return;
+
     auto numBlocks = fs.blocks();
-    BlockNr i = ap;
 
-    while (!fs.isEmpty(i)) {
+    if (!ensureIndex()) {
+
+        // Fall back to a linear search if the bitmap is unreadable
+        BlockNr i = ap;
+        while (count > 0) {
+
+            if (fs.isEmpty(i)) { result.push_back(i); count--; }
 
-        if ((i = (i + 1) % numBlocks) == ap) {
+            i = (i + 1) % numBlocks;
+            if (i == ap && count > 0) {
 
-            loginfo(FS_DEBUG, "No more free blocks\n");
-            throw FSError(FSError::FS_OUT_OF_SPACE);
+                loginfo(FS_DEBUG, "No more free blocks\n");
+                throw FSError(FSError::FS_OUT_OF_SPACE);
+            }
         }
+        return;
+    }
+
+    if (freeCount < count) {
+
+        loginfo(FS_DEBUG, "No more free blocks\n");
+        throw FSError(FSError::FS_OUT_OF_SPACE);
     }
 
+    // Searches a run of 'count' free blocks starting in [lower; upper)
+    auto findRun = [&](isize lower, isize upper) {
+
+        for (isize i = nextFree(lower); i >= 0 && i < upper; ) {
+
+            auto j = nextUsed(i, std::min(i + count, numBlocks));
+            if (j - i == count) return i;
+            i = nextFree(j);
+        }
+        return isize(-1);
+    };
+
+    // Prefer a contiguous run, starting at the allocation pointer
+    auto run = findRun(ap, numBlocks);
+    if (run < 0) run = findRun(0, ap);
+
+    if (run >= 0) {
+
+        for (isize i = 0; i < count; i++) result.push_back(BlockNr(run + i));
+        return;
+    }
+
+    // Otherwise, collect free blocks in ascending order, wrapping around once
+    for (isize i = nextFree(ap); count > 0; count--) {
+
+        if (i < 0) i = nextFree(0);
+        result.push_back(BlockNr(i));
+        i = nextFree(i + 1);
+    }
+}
+
+BlockNr
+FSAllocator::allocate()
+{
+    std::vector<BlockNr> result;
+    locateFree(1, result);
+
+    auto i = result.front();
     fs.fetch(i).mutate().init(FSBlockType::UNKNOWN);
     markAsAllocated(i);
-    ap = (i + 1) % numBlocks;
+    ap = (i + 1) % fs.blocks();
     return i;
 }
 
@@ -122,45 +178,35 @@ FSAllocator::allocate(isize count, std::vector<BlockNr> &result, std::vector<Blo
     }
 
     // Step 2: Allocate remaining blocks from free space
-    BlockNr i = ap;
-    while (count > 0) {
-
-        if (fs.isEmpty(i)) {
-
-            fs.fetch(i).mutate().type = FSBlockType::UNKNOWN;
-            result.push_back(i);
-            count--;
-        }
-
-        // Move to the next block
-        i = (i + 1) % fs.blocks();
+    std::vector<BlockNr> blocks;
+    locateFree(count, blocks);
 
-        // Fail if we looped all the way and still need blocks
-        if (i == ap && count > 0) {
+    for (auto b : blocks) {
 
-            loginfo(FS_DEBUG, "No more free blocks\n");
-            throw FSError(FSError::FS_OUT_OF_SPACE);
-        }
+        fs.fetch(b).mutate().type = FSBlockType::UNKNOWN;
+        result.push_back(b);
     }
 
     // Step 3: Mark all blocks as allocated
-    for (const auto &b : result) markAsAllocated(b);
+    markAsAllocated(result);
 
     // Step 4: Advance allocation pointer
-    ap = i;
+    if (!blocks.empty()) ap = (blocks.back() + 1) % fs.blocks();
 }
 
 void
 FSAllocator::deallocateBlock(BlockNr nr)
 {
-    fs.fetch(nr).mutate().init(FSBlockType::EMPTY);
-    markAsFree(nr);
+    deallocateBlocks({ nr });
 }
 
 void
 FSAllocator::deallocateBlocks(const std::vector<BlockNr> &nrs)
 {
-    for (BlockNr nr : nrs) { deallocateBlock(nr); }
+    // Drop the blocks from the cache. Their contents stay on the volume, but
+    // the allocation bitmap no longer refers to them.
+    for (BlockNr nr : nrs) fs.cache.erase(nr);
+    markAsFree(nrs);
 }
 
 void
@@ -179,6 +225,9 @@ FSAllocator::allocateFileBlocks(isize bytes,
         are allocated and appended to the respective lists.
     */
 
+    // Indicates whether the allocation bitmap has been modified
+    bool modified = false;
+
     auto freeSurplus = [&](std::vector<BlockNr> &blocks, usize count) {
 
         if (blocks.size() > count) {
@@ -187,6 +236,7 @@ FSAllocator::allocateFileBlocks(isize bytes,
                 deallocateBlock(blocks[i]);
             }
             blocks.resize(count);
+            modified = true;
 
         } else {
 
@@ -198,14 +248,22 @@ FSAllocator::allocateFileBlocks(isize bytes,
     auto ensureDataBlocks = [&](isize n) {
 
         dataBlocksNeeded += n;
-        while (dataBlocks.size() < dataBlocksNeeded) allocate(1, dataBlocks);
+        if (dataBlocks.size() < dataBlocksNeeded) {
+
+            allocate(isize(dataBlocksNeeded - dataBlocks.size()), dataBlocks);
+            modified = true;
+        }
     };
 
     usize listBlocksNeeded = 0;
     auto ensureListBlocks = [&](isize n) {
 
         listBlocksNeeded += n;
-        while (listBlocks.size() < listBlocksNeeded) allocate(1, listBlocks);
+        if (listBlocks.size() < listBlocksNeeded) {
+
+            allocate(isize(listBlocksNeeded - listBlocks.size()), listBlocks);
+            modified = true;
+        }
     };
 
     isize numDataBlocks         = requiredDataBlocks(bytes);
@@ -213,7 +271,7 @@ FSAllocator::allocateFileBlocks(isize bytes,
     isize refsPerBlock          = (traits.bsize / 4) - 56;
     isize refsInHeaderBlock     = std::min(numDataBlocks, refsPerBlock);
     isize refsInListBlocks      = numDataBlocks - refsInHeaderBlock;
-    isize refsInLastListBlock   = refsInListBlocks % refsPerBlock;
+    isize refsInLastListBlock   = refsInListBlocks - std::max(numListBlocks - 1, isize(0)) * refsPerBlock;
 
     loginfo(FS_DEBUG, "                   Data bytes : %ld\n", bytes);
     loginfo(FS_DEBUG, "         Required data blocks : %ld\n", numDataBlocks);
@@ -227,29 +285,55 @@ FSAllocator::allocateFileBlocks(isize bytes,
     freeSurplus(listBlocks, numListBlocks);
     freeSurplus(dataBlocks, numDataBlocks);
 
-    if (traits.ofs()) {
+    auto rectifyChecksums = [&]() {
+
+        if (modified) {
 
-        // Header block -> Data blocks -> List block -> Data blocks ... List block -> Data blocks
-        ensureDataBlocks(refsInHeaderBlock);
+            for (auto &it : fs.getBmBlocks()) fs[it].mutate().updateChecksum();
+            for (auto &it : fs.getBmExtBlocks()) fs[it].mutate().updateChecksum();
+        }
+    };
+
+    // Remember the provided blocks in case the volume runs out of space
+    auto providedListBlocks = listBlocks.size();
+    auto providedDataBlocks = dataBlocks.size();
+
+    try {
+
+        if (traits.ofs()) {
+
+            // Header block -> Data blocks -> List block -> Data blocks ... List block -> Data blocks
+            ensureDataBlocks(refsInHeaderBlock);
+
+            for (isize i = 0; i < numListBlocks; i++) {
 
-        for (isize i = 0; i < numListBlocks; i++) {
+                ensureListBlocks(1);
+                ensureDataBlocks(i < numListBlocks - 1 ? refsPerBlock : refsInLastListBlock);
+            }
+        }
 
-            ensureListBlocks(1);
-            ensureDataBlocks(i < numListBlocks - 1 ? refsPerBlock : refsInLastListBlock);
+        if (traits.ffs()) {
+
+            // Header block -> Data blocks -> All list block -> All remaining data blocks
+            ensureDataBlocks(refsInHeaderBlock);
+            ensureListBlocks(numListBlocks);
+            ensureDataBlocks(refsInListBlocks);
         }
-    }
 
-    if (traits.ffs()) {
+    } catch (...) {
 
-        // Header block -> Data blocks -> All list block -> All remaining data blocks
-        ensureDataBlocks(refsInHeaderBlock);
-        ensureListBlocks(numListBlocks);
-        ensureDataBlocks(refsInListBlocks);
+        // Release the blocks allocated so far. They aren't referenced by any file yet
+        std::vector<BlockNr> added(listBlocks.begin() + providedListBlocks, listBlocks.end());
+        added.insert(added.end(), dataBlocks.begin() + providedDataBlocks, dataBlocks.end());
+        deallocateBlocks(added);
+        listBlocks.resize(providedListBlocks);
+        dataBlocks.resize(providedDataBlocks);
+
+        rectifyChecksums();
+        throw;
     }
 
-    // Rectify checksums
-    for (auto &it : fs.getBmBlocks()) fs[it].mutate().updateChecksum();
-    for (auto &it : fs.getBmExtBlocks()) fs[it].mutate().updateChecksum();
+    rectifyChecksums();
 }
 
 bool
@@ -332,7 +416,12 @@ FSAllocator::numUnallocated() const noexcept
     if (!fs.isFormatted()) return 0;
     
     isize result = 0;
-    for (auto &it : readBitmap()) result += std::popcount(it);
+
+    if (ensureIndex()) {
+        result = freeCount;
+    } else {
+        for (auto &it : readBitmap()) result += std::popcount(it);
+    }
 
     if constexpr (debug::FS_DEBUG) {
 
@@ -391,9 +480,130 @@ FSAllocator::setAllocBit(BlockNr nr, bool value)
     
     if (auto *bm = locateAllocationBit(nr, &byte, &bit)) {
 
-        auto *data = bm->mutate().data();
-        REPLACE_BIT(data[byte], bit, value);
+        // Modify the containing long word to keep the running checksum intact
+        auto &blk = bm->mutate();
+        auto word = blk.get32(byte / 4);
+        REPLACE_BIT(word, (3 - byte % 4) * 8 + bit, value);
+        blk.set32(byte / 4, word);
+        updateIndex(nr, value);
+    }
+}
+
+void
+FSAllocator::setAllocBits(const std::vector<BlockNr> &nrs, bool value)
+{
+    const FSBlock *bm = nullptr;
+    FSBlock *target = nullptr;
+    isize byte, bit;
+
+    for (auto nr : nrs) {
+
+        if (auto *blk = locateAllocationBit(nr, &byte, &bit)) {
+
+            // Only touch a bitmap block once per run of bits it stores
+            if (blk != bm) { bm = blk; target = &blk->mutate(); }
+
+            auto word = target->get32(byte / 4);
+            REPLACE_BIT(word, (3 - byte % 4) * 8 + bit, value);
+            target->set32(byte / 4, word);
+            updateIndex(nr, value);
+        }
+    }
+}
+
+bool
+FSAllocator::ensureIndex() const
+{
+    if (indexed) return indexable;
+
+    auto numBlocks = fs.blocks();
+    auto bitmap = readBitmap();
+
+    indexed = true;
+    indexable = !bitmap.empty() && isize(bitmap.size()) == ((numBlocks - 2) + 31) / 32;
+
+    freeMap.assign((numBlocks + 63) / 64, 0);
+    summary.assign((freeMap.size() + 63) / 64, 0);
+    freeCount = 0;
+
+    if (indexable) {
+
+        // Bit n of the bitmap represents block n + 2
+        for (isize w = 0; w < isize(bitmap.size()); w++) {
+            for (u32 bits = bitmap[w]; bits; bits &= bits - 1) {
+                updateIndex(BlockNr(2 + 32 * w + std::countr_zero(bits)), true);
+            }
+        }
+    }
+
+    loginfo(FS_DEBUG, "Indexed %ld free blocks\n", freeCount);
+    return indexable;
+}
+
+void
+FSAllocator::updateIndex(BlockNr nr, bool free) const
+{
+    if (!indexed || !indexable || isize(nr) >= fs.blocks()) return;
+
+    auto w = isize(nr) / 64;
+    auto mask = u64(1) << (nr % 64);
+
+    if (bool(freeMap[w] & mask) == free) return;
+
+    if (free) {
+
+        freeMap[w] |= mask;
+        summary[w / 64] |= u64(1) << (w % 64);
+        freeCount++;
+
+    } else {
+
+        freeMap[w] &= ~mask;
+        if (!freeMap[w]) summary[w / 64] &= ~(u64(1) << (w % 64));
+        freeCount--;
+    }
+}
+
+isize
+FSAllocator::nextFree(isize nr) const
+{
+    if (nr >= fs.blocks()) return -1;
+
+    // Check the word containing the start block
+    auto w = nr / 64;
+    if (auto bits = freeMap[w] & (~u64(0) << (nr % 64))) {
+        return w * 64 + std::countr_zero(bits);
+    }
+
+    // Consult the summary to skip fully allocated words
+    if (++w >= isize(freeMap.size())) return -1;
+
+    for (auto s = w / 64; s < isize(summary.size()); s++) {
+
+        auto bits = summary[s];
+        if (s == w / 64) bits &= ~u64(0) << (w % 64);
+
+        if (bits) {
+
+            auto word = s * 64 + std::countr_zero(bits);
+            return word * 64 + std::countr_zero(freeMap[word]);
+        }
+    }
+    return -1;
+}
+
+isize
+FSAllocator::nextUsed(isize nr, isize limit) const
+{
+    for (isize i = nr; i < limit; ) {
+
+        auto w = i / 64;
+        if (auto bits = ~freeMap[w] & (~u64(0) << (i % 64))) {
+            return std::min(limit, w * 64 + std::countr_zero(bits));
+        }
+        i = (w + 1) * 64;
     }
+    return limit;
 }
 
 }
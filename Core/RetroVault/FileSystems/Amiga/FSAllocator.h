@@ -20,6 +20,26 @@ public:
     // Allocation pointer (selects the block to allocate next)
     BlockNr ap = 0;
 
+private:
+
+    /* Free block index (mirrors the allocation bitmap)
+     *
+     * Bit n of freeMap is set iff block n is free. Bit k of summary is set iff
+     * freeMap[k] contains at least one free block. The index is built on
+     * demand and updated whenever an allocation bit is modified.
+     */
+    mutable std::vector<u64> freeMap;
+    mutable std::vector<u64> summary;
+    mutable isize freeCount = 0;
+
+    // Indicates if the index is up to date
+    mutable bool indexed = false;
+
+    // Indicates if the index could be built (the bitmap is readable)
+    mutable bool indexable = false;
+
+public:
+
     using FSService::FSService;
 
 
@@ -32,8 +52,6 @@ public:
     // Returns the number of required blocks to store a file of certain size
     [[nodiscard]] isize requiredBlocks(isize fileSize) const noexcept;
 
-private:
-
     // Returns the number of required file list or data blocks
     [[nodiscard]] isize requiredFileListBlocks(isize fileSize) const noexcept;
     [[nodiscard]] isize requiredDataBlocks(isize fileSize) const noexcept;
@@ -48,6 +66,9 @@ public:
     // Returns true if at least 'count' free blocks are available
     [[nodiscard]] bool allocatable(isize count) const noexcept;
 
+    // Collects free blocks without allocating them (prefers contiguous runs)
+    void locateFree(isize count, std::vector<BlockNr> &result) const;
+
     // Seeks a free block and marks it as allocated
     BlockNr allocate();
 
@@ -83,8 +104,28 @@ public:
     void markAsFree(BlockNr nr) { setAllocBit(nr, 1); }
     void setAllocBit(BlockNr nr, bool value);
 
+    // Marks multiple blocks as allocated or free
+    void markAsAllocated(const std::vector<BlockNr> &nrs) { setAllocBits(nrs, 0); }
+    void markAsFree(const std::vector<BlockNr> &nrs) { setAllocBits(nrs, 1); }
+    void setAllocBits(const std::vector<BlockNr> &nrs, bool value);
+
+    // Discards the free block index (it is rebuilt on the next request)
+    void invalidate() { indexed = false; }
+
 private:
 
+    // Builds the free block index if needed (returns false if not indexable)
+    bool ensureIndex() const;
+
+    // Updates the free block index
+    void updateIndex(BlockNr nr, bool free) const;
+
+    // Returns the first free block at or after nr (or -1 if none)
+    isize nextFree(isize nr) const;
+
+    // Returns the first allocated block in [nr; limit) (or limit if none)
+    isize nextUsed(isize nr, isize limit) const;
+
     // Locates the allocation bit for a certain block
     // FSBlock *locateAllocationBit(BlockNr nr, isize *byte, isize *bit) noexcept;
     const FSBlock *locateAllocationBit(BlockNr nr, isize *byte, isize *bit) const noexcept;
@@ -14,6 +14,7 @@
 #include "utl/support.h"
 #include <algorithm>
 #include <fstream>
+#include <utility>
 
 namespace retro::vault::amiga {
 
@@ -29,7 +30,7 @@ FSBlock::FSBlock(FileSystem *ref, BlockNr nr, FSBlockType t) : FSBlock(ref, nr)
 
 FSBlock::~FSBlock()
 {
-
+    if (dataCache) cache.release(*this);
 }
 
 void
@@ -45,17 +46,16 @@ FSBlock::init(FSBlockType t)
 
     // Wipe out existing data
     memset(bdata, 0, bsize());
-    
+    sum = 0;
+    sumValid = true;
+
     // Initialize
     switch (type) {
 
         case FSBlockType::BOOT:
 
             if (nr == 0 && fs->traits.dos != FSFormat::NODOS) {
-                bdata[0] = 'D';
-                bdata[1] = 'O';
-                bdata[2] = 'S';
-                bdata[3] = (u8)fs->traits.dos;
+                set32(0, HI_HI_LO_LO('D', 'O', 'S', (u8)fs->traits.dos));
             }
             break;
 
@@ -507,22 +507,19 @@ FSBlock::addr32(isize nr)
 u8 *
 FSBlock::data()
 {
-    if (dataCache.empty()) {
-
-        dataCache.alloc(bsize());
-        cache.dev.readBlock(dataCache.ptr, nr);
-    }
-
-    assert(dataCache.size == bsize());
-    assert(dataCache.ptr);
+    // The caller may modify the data behind our back
+    sumValid = false;
 
-    return dataCache.ptr;
+    return const_cast<u8 *>(std::as_const(*this).data());
 }
 
 const u8 *
 FSBlock::data() const
 {
-    return const_cast<const u8 *>(const_cast<FSBlock *>(this)->data());
+    if (!dataCache) cache.load(const_cast<FSBlock &>(*this));
+    assert(dataCache);
+
+    return dataCache;
 }
 
 FSBlock &
@@ -541,9 +538,9 @@ FSBlock::invalidate()
 void
 FSBlock::flush()
 {
-    if (!dataCache.empty()) {
+    if (dataCache) {
         
-        cache.dev.writeBlock(dataCache.ptr, nr);
+        cache.write(dataCache, nr);
     }
 }
 
@@ -562,6 +559,37 @@ FSBlock::write32(u8 *p, u32 value)
     p[3] = (value >>  0) & 0xFF;
 }
 
+void
+FSBlock::set32(isize n, isize val)
+{
+    auto *p = const_cast<u8 *>(std::as_const(*this).addr32(n));
+
+    // Keep the running sum up to date
+    if (sumValid) U32_INC(sum, U32_SUB(u32(val), read32(p)));
+
+    write32(p, u32(val));
+}
+
+void
+FSBlock::setBytes(isize offset, const u8 *src, isize count)
+{
+    assert(offset >= 0 && count >= 0 && offset + count <= bsize());
+
+    auto *p = const_cast<u8 *>(std::as_const(*this).data());
+
+    if (!sumValid) {
+
+        std::memcpy(p + offset, src, count);
+        return;
+    }
+
+    // Replace the contribution of all affected long words
+    auto first = offset / 4, last = (offset + count + 3) / 4;
+    for (isize i = first; i < last; i++) U32_DEC(sum, read32(p + 4 * i));
+    std::memcpy(p + offset, src, count);
+    for (isize i = first; i < last; i++) U32_INC(sum, read32(p + 4 * i));
+}
+
 isize
 FSBlock::checksumLocation() const
 {
@@ -601,26 +629,29 @@ FSBlock::checksumStandard() const
     isize pos = checksumLocation();
     assert(pos >= 0 && pos <= 5);
 
-    // Wipe out the old checksum
-    u32 old = get32(pos);
-    const_cast<FSBlock *>(this)->set32(pos, 0); // TODO: DON'T DO THIS
+    // Sum up all long words if the running sum is outdated
+    if (!sumValid) {
 
-    // Compute the new checksum
-    u32 result = 0;
-    for (isize i = 0; i < bsize() / 4; i++)  U32_INC(result, get32(i));
-    result = ~result;
-    U32_INC(result, 1);
+        sum = 0;
+        for (isize i = 0; i < bsize() / 4; i++) U32_INC(sum, get32(i));
+        sumValid = true;
+
+    } else if constexpr (debug::FS_CHECKSUM) {
 
-    // Undo the modification
-    const_cast<FSBlock *>(this)->set32(pos, old); // TODO: DON'T DO THIS
+        u32 expected = 0;
+        for (isize i = 0; i < bsize() / 4; i++) U32_INC(expected, get32(i));
 
-    // Compute the new checksum
-    u32 result2 = 0;
-    for (isize i = 0; i < bsize() / 4; i++)  if (i != pos) U32_INC(result2, get32(i));
-    result2 = ~result2;
-    U32_INC(result2, 1);
+        if (sum != expected) {
 
-    assert(result == result2);
+            logwarn("Block %ld: Running sum %x differs from %x\n", nr, sum, expected);
+            assert(false);
+        }
+    }
+
+    // Exclude the stored checksum from the sum
+    u32 result = U32_SUB(sum, get32(pos));
+    result = ~result;
+    U32_INC(result, 1);
 
     return result;
 }
@@ -641,7 +672,7 @@ FSBlock::checksumBootBlock() const
     }
 
     // Second boot block
-    auto *p = fs->cache[1].data();
+    auto *p = std::as_const(fs->cache[1]).data();
 
     for (isize i = 0; i < bsize() / 4; i++) {
 
@@ -36,8 +36,15 @@ struct FSBlock : Loggable, Hashable, Dumpable {
     // The sector number of this block
     BlockNr nr = 0;
 
-    // Cached block data
-    Buffer<u8> dataCache;
+    // Cached block data (a frame, the device memory in mapped mode, or nullptr)
+    u8 *dataCache = nullptr;
+
+    // Index of the cache frame holding the block data (-1 if none)
+    isize frame = -1;
+
+    // Running sum of all long words (only meaningful if sumValid is set)
+    mutable u32 sum = 0;
+    mutable bool sumValid = false;
 
 
     //
@@ -67,7 +74,7 @@ public:
 
     u64 hash(HashAlgorithm algorithm) const override {
 
-        return dataCache.empty() ? 0 : dataCache.hash(algorithm);
+        return dataCache ? Hashable::hash(dataCache, bsize(), algorithm) : 0;
     }
 
 
@@ -77,10 +84,10 @@ public:
 
     Dumpable::DataProvider dataProvider() const override {
 
-        if (dataCache.empty()) {
+        if (!dataCache) {
             return [&](isize offset, isize bytes) { return offset < bsize() ? 0 : -1; };
         } else {
-            return dataCache.dataProvider();
+            return Dumpable::dataProvider(dataCache, bsize());
         }
     }
 
@@ -146,7 +153,8 @@ public:
     // Reading and writing block data
     //
 
-    // Provides the data of a block
+    // Provides the data of a block (write access discards the running sum).
+    // The pointer is only valid until the next block is fetched.
     u8 *data();
     const u8 *data() const;
 
@@ -171,9 +179,12 @@ public:
 
     // Reads, writes, or modifies the n-th long word
     u32 get32(isize n) const { return read32(addr32(n)); }
-    void set32(isize n, isize val) { write32(addr32(n), u32(val)); }
-    void inc32(isize n) { inc32(addr32(n)); }
-    void dec32(isize n) { dec32(addr32(n)); }
+    void set32(isize n, isize val);
+    void inc32(isize n) { set32(n, get32(n) + 1); }
+    void dec32(isize n) { set32(n, get32(n) - 1); }
+
+    // Copies a range of bytes into the block
+    void setBytes(isize offset, const u8 *src, isize count);
 
     // Returns the location of the checksum inside this block
     isize checksumLocation() const;
@@ -12,12 +12,12 @@
 #include "FileSystems/Amiga/FileSystem.h"
 #include "utl/io.h"
 #include <algorithm>
+#include <utility>
 
 namespace retro::vault::amiga {
 
 FSCache::FSCache(FileSystem &fs, Volume &v) : FSService(fs), dev(v) {
 
-    blocks.reserve(v.capacity());
 };
 
 FSCache::~FSCache()
@@ -29,6 +29,13 @@ void
 FSCache::dealloc()
 {
     blocks.clear();
+    dirty.clear();
+    slabs.clear();
+    frames.clear();
+    freeFrames.clear();
+    head = tail = -1;
+    aheadRange = { };
+    lastMiss = -1;
 }
 
 void
@@ -38,6 +45,11 @@ FSCache::dump(std::ostream &os) const
 
     os << tab("Capacity") << capacity() << " blocks (x " << bsize() << " bytes)" << std::endl;
     os << tab("Hashed blocks") << blocks.size() << std::endl;
+    os << tab("Cached blocks") << cachedBlocks() << " (limit " << limit << ")" << std::endl;
+    os << tab("Dirty blocks") << dirtyBlocks() << std::endl;
+    os << tab("Hits / Misses") << hits << " / " << misses << std::endl;
+    os << tab("Evictions") << evictions << std::endl;
+    os << tab("Mapped") << bol(mapped && dev.map()) << std::endl;
 }
 
 FSFormat
@@ -93,26 +105,82 @@ FSCache::cache(BlockNr nr) const noexcept
 {
     if (isize(nr) >= capacity()) return nullptr;
 
+    std::unique_lock<std::mutex> lock(mutex, std::defer_lock);
+    if (concurrent) lock.lock();
+
     // Look up the block in the cache and return it if already present
     // On a miss, reserve an entry with a placeholder value
     auto [it, inserted] = blocks.try_emplace(nr, nullptr);
-    if (!inserted) return it->second.get();
 
-    // Create the block cache entry
-    auto block = std::make_unique<FSBlock>(&fs, nr);
-    block->dataCache.alloc(bsize());
+    if (!inserted) {
+
+        auto *block = it->second.get();
+
+        // Mark the block as recently used
+        if (block->dataCache) {
+
+            hits++;
+            if (block->frame >= 0 && frames[block->frame].linked) {
+                unlink(block->frame); link(block->frame);
+            }
+
+        } else if (concurrent) {
 
-    // Read block data from the underlying block device
-    dev.readBlock(block->dataCache.ptr, nr);
+            // Other threads must not observe a lazy load
+            load(*block);
+        }
+        return block;
+    }
+
+    // Create the block cache entry and read the block data
+    auto block = std::make_unique<FSBlock>(&fs, nr);
+    load(*block);
 
     // Predict the block type based on its number and cached data
-    block->type = fs.predictType(nr, block->dataCache.ptr);
+    block->type = fs.predictType(nr, block->dataCache);
 
     // Populate the reserved cache entry
     it->second = std::move(block);
     return it->second.get();
 }
 
+void
+FSCache::prefetch(std::span<const BlockNr> nrs) const
+{
+    auto present = [&](BlockNr nr) {
+
+        auto it = blocks.find(nr);
+        return it != blocks.end() && it->second->dataCache;
+    };
+
+    // Mapped blocks are accessible without reading
+    if (mapped && dev.map()) { for (auto nr : nrs) cache(nr); return; }
+
+    for (usize i = 0, j = 0; i < nrs.size(); i = j) {
+
+        // Skip blocks that are already present or out of range
+        j = i + 1;
+        if (present(nrs[i]) || isize(nrs[i]) >= capacity()) continue;
+
+        // Determine the run of consecutive blocks starting here
+        while (j < nrs.size() && nrs[j] == nrs[j - 1] + 1 &&
+               isize(nrs[j]) < capacity() && isize(j - i) < readAheadSize) j++;
+
+        // Read the run in a single request
+        if (j - i > 1) {
+
+            aheadRange = Range<isize> { nrs[i], nrs[j - 1] + 1 };
+            if (ahead.size < aheadRange.size() * bsize()) ahead.alloc(readAheadSize * bsize());
+            dev.readBlocks(ahead.ptr, aheadRange);
+        }
+
+        // Load the block data
+        for (usize k = i; k < j; k++) {
+            if (auto *block = cache(nrs[k]); block && !block->dataCache) load(*block);
+        }
+    }
+}
+
 const FSBlock *
 FSCache::tryFetch(BlockNr nr) const noexcept
 {
@@ -236,7 +304,13 @@ FSCache::modify(BlockNr nr, std::vector<FSBlockType> types)
 void
 FSCache::erase(BlockNr nr)
 {
-    if (blocks.contains(nr)) { blocks.erase(nr); }
+    if (auto it = blocks.find(nr); it != blocks.end()) {
+
+        // Return the frame before the block object is destroyed
+        if (it->second->dataCache) release(*it->second);
+        blocks.erase(it);
+    }
+    dirty.erase(nr);
 }
 
 void
@@ -244,6 +318,14 @@ FSCache::markAsDirty(BlockNr nr)
 {
     dirty.insert(nr);
     fs.stepGeneration();
+
+    // Pin the block data until the next flush
+    if (auto it = blocks.find(nr); it != blocks.end() && it->second->dataCache) {
+
+        // Create a private copy if the block refers to the device memory
+        if (it->second->frame < 0) materialize(*it->second);
+        if (frames[it->second->frame].linked) unlink(it->second->frame);
+    }
 }
 
 void
@@ -273,7 +355,7 @@ FSCache::flush()
             if (it == blocks.end())
                 throw FSError(FSError::FS_CORRUPTED, "Cache mismatch: " + std::to_string(i));
             
-            memcpy(buffer.data() + (i - seg.lower) * bs, it->second->data(), bs);
+            memcpy(buffer.data() + (i - seg.lower) * bs, std::as_const(*it->second).data(), bs);
         }
         
         // Write the buffer back to the device
@@ -281,7 +363,14 @@ FSCache::flush()
         
     }
     
-    // Mark all blocks as up-to-date
+    // The read-ahead buffer may contain outdated data now
+    aheadRange = { };
+
+    // Mark all blocks as up-to-date and release the pinned frames
+    for (auto nr : dirty) {
+
+        if (auto *block = blocks.at(nr).get(); block->dataCache) link(block->frame);
+    }
     dirty.clear();
 }
 
@@ -294,8 +383,196 @@ FSCache::updateChecksums()
 void
 FSCache::invalidate()
 {
-    blocks.clear();
-    dirty.clear();
+    dealloc();
+}
+
+void
+FSCache::setLimit(isize frames)
+{
+    limit = std::max(frames, slabSize);
+}
+
+void
+FSCache::setConcurrent(bool value)
+{
+    std::lock_guard<std::mutex> guard(mutex);
+    concurrent = value;
+}
+
+void
+FSCache::setMapped(bool value)
+{
+    if (mapped == value) return;
+
+    // Drop all references into the device memory
+    if (mapped) {
+
+        for (auto &[nr, block] : blocks) {
+            if (block->dataCache && block->frame < 0) release(*block);
+        }
+    }
+    mapped = value;
+}
+
+void
+FSCache::trim()
+{
+    // Return to the frame limit if it has been exceeded in concurrent mode
+    while (cachedBlocks() > limit && tail >= 0) {
+
+        release(*frames[tail].block);
+        evictions++;
+    }
+
+    // Only proceed if the number of block objects has grown significantly
+    if (isize(blocks.size()) <= 2 * limit) return;
+
+    loginfo(FS_DEBUG, "Trimming %zu blocks\n", blocks.size());
+
+    std::erase_if(blocks, [&](const auto &it) {
+        return (!it.second->dataCache || it.second->frame < 0) && !dirty.contains(it.first);
+    });
+}
+
+void
+FSCache::link(isize f) const
+{
+    assert(!frames[f].linked);
+
+    frames[f].prev = -1;
+    frames[f].next = head;
+    frames[f].linked = true;
+
+    if (head >= 0) frames[head].prev = f; else tail = f;
+    head = f;
+}
+
+void
+FSCache::unlink(isize f) const
+{
+    assert(frames[f].linked);
+
+    auto &frame = frames[f];
+    if (frame.prev >= 0) frames[frame.prev].next = frame.next; else head = frame.next;
+    if (frame.next >= 0) frames[frame.next].prev = frame.prev; else tail = frame.prev;
+    frame.prev = frame.next = -1;
+    frame.linked = false;
+}
+
+isize
+FSCache::acquireFrame() const
+{
+    if (cachedBlocks() >= limit && tail >= 0 && !concurrent) {
+
+        // Evict the least recently used clean block
+        auto *victim = frames[tail].block;
+        assert(victim && !dirty.contains(victim->nr));
+
+        release(*victim);
+        evictions++;
+    }
+
+    if (freeFrames.empty()) {
+
+        // Allocate a new slab
+        slabs.push_back(std::make_unique<u8[]>(slabSize * bsize()));
+
+        auto first = isize(frames.size());
+        frames.resize(frames.size() + slabSize);
+        for (isize i = slabSize - 1; i >= 0; i--) freeFrames.push_back(first + i);
+    }
+
+    auto result = freeFrames.back();
+    freeFrames.pop_back();
+    return result;
+}
+
+void
+FSCache::load(FSBlock &block) const
+{
+    assert(!block.dataCache);
+
+    // Refer to the device memory if possible
+    if (auto *mem = mapped ? dev.map() : nullptr; mem && !dirty.contains(block.nr)) {
+
+        misses++;
+        block.frame = -1;
+        block.dataCache = const_cast<u8 *>(mem) + block.nr * bsize();
+        return;
+    }
+
+    auto f = acquireFrame();
+
+    frames[f].block = &block;
+    block.frame = f;
+    block.dataCache = frameAddr(f);
+    read(block.dataCache, block.nr);
+
+    // Dirty blocks stay pinned until the next flush
+    if (!dirty.contains(block.nr)) link(f);
+}
+
+void
+FSCache::materialize(FSBlock &block) const
+{
+    assert(block.dataCache && block.frame < 0);
+
+    auto f = acquireFrame();
+
+    frames[f].block = &block;
+    std::memcpy(frameAddr(f), block.dataCache, bsize());
+    block.frame = f;
+    block.dataCache = frameAddr(f);
+}
+
+void
+FSCache::release(FSBlock &block) const
+{
+    assert(block.dataCache);
+
+    // Blocks referring to the device memory occupy no frame
+    if (block.frame < 0) { block.dataCache = nullptr; block.sumValid = false; return; }
+
+    auto f = block.frame;
+    if (frames[f].linked) unlink(f);
+
+    frames[f].block = nullptr;
+    block.frame = -1;
+    block.dataCache = nullptr;
+    block.sumValid = false;
+    freeFrames.push_back(f);
+}
+
+void
+FSCache::read(u8 *dst, BlockNr nr) const
+{
+    auto bs = bsize();
+    misses++;
+
+    if (!aheadRange.contains(nr) && nr == lastMiss + 1) {
+
+        // Read the following blocks in a single request
+        aheadRange = Range<isize> { nr, std::min(nr + readAheadSize, capacity()) };
+        if (ahead.size < aheadRange.size() * bs) ahead.alloc(readAheadSize * bs);
+        dev.readBlocks(ahead.ptr, aheadRange);
+    }
+    lastMiss = nr;
+
+    if (aheadRange.contains(nr)) {
+
+        std::memcpy(dst, ahead.ptr + (nr - aheadRange.lower) * bs, bs);
+
+    } else {
+
+        dev.readBlock(dst, nr);
+    }
+}
+
+void
+FSCache::write(const u8 *src, BlockNr nr)
+{
+    if (aheadRange.contains(nr)) aheadRange = { };
+    dev.writeBlock(src, nr);
 }
 
 }
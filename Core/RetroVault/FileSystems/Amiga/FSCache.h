@@ -15,15 +15,69 @@
 #include "FileSystems/Amiga/FSService.h"
 #include "Volume.h"
 #include <iostream>
+#include <mutex>
 #include <ranges>
+#include <span>
 #include <unordered_set>
 
 namespace retro::vault::amiga {
 
+/* The cache keeps an FSBlock object for each block that has been accessed.
+ * The block data is stored separately in frames of fixed size, which are
+ * allocated in slabs. The number of frames is bounded. If all frames are in
+ * use, the frame of the least recently used clean block is reclaimed. The
+ * FSBlock object stays alive, which keeps all handed out block references
+ * valid, and its data is reloaded on the next access. Dirty blocks are pinned
+ * until they are written back by flush().
+ *
+ * Because frames are recycled, pointers to block data (see FSBlock::data())
+ * are only guaranteed to be valid until the next block is fetched. As a
+ * safety margin, the limit never drops below one slab, which keeps the most
+ * recently used blocks in place.
+ *
+ * Block objects whose data has been evicted are released by trim(). This
+ * function must only be called at points where no block references are held.
+ *
+ * Misses on consecutive block numbers trigger a read-ahead. The following
+ * blocks are read from the volume in a single request and kept in a staging
+ * buffer until they are accessed.
+ *
+ * In concurrent mode, multiple threads may read blocks simultaneously. All
+ * lookups are serialized by a mutex, block data is loaded eagerly, and no
+ * frames are evicted. Hence, the data of each handed out block stays in place
+ * until concurrent mode is left. Blocks must not be modified in this mode.
+ *
+ * In mapped mode, the data of clean blocks is not copied. If the volume is
+ * backed by memory, blocks refer to the device memory directly and occupy no
+ * frame. A block receives a private copy in a frame once it is marked dirty.
+ * The device memory must not be reallocated while blocks refer to it.
+ */
 class FSCache final : public FSService {
     
     friend struct FSBlock;
     
+    // Number of frames in a slab
+    static constexpr isize slabSize = 256;
+
+    // Default frame limit
+    static constexpr isize defaultLimit = 16384;
+
+    // Number of blocks in a read-ahead request
+    static constexpr isize readAheadSize = 32;
+
+    struct Frame {
+
+        // The block occupying this frame (nullptr if the frame is unused)
+        FSBlock *block = nullptr;
+
+        // Neighbours in the LRU list (-1 = none)
+        isize prev = -1;
+        isize next = -1;
+
+        // Indicates if the frame is contained in the LRU list
+        bool linked = false;
+    };
+
 private:
     
     // The underlying volume
@@ -35,6 +89,37 @@ private:
     // Dirty blocks
     mutable std::unordered_set<BlockNr> dirty;
     
+    // Frame storage
+    mutable std::vector<std::unique_ptr<u8[]>> slabs;
+    mutable std::vector<Frame> frames;
+    mutable std::vector<isize> freeFrames;
+
+    // LRU list of frames holding clean blocks (head = most recently used)
+    mutable isize head = -1;
+    mutable isize tail = -1;
+
+    // Maximum number of frames (exceeded only if all frames are pinned)
+    isize limit = defaultLimit;
+
+    // Read-ahead staging buffer
+    mutable Buffer<u8> ahead;
+    mutable Range<isize> aheadRange;
+
+    // Block number of the latest miss
+    mutable isize lastMiss = -1;
+
+    // Guards the cache in concurrent mode
+    mutable std::mutex mutex;
+    bool concurrent = false;
+
+    // Indicates if clean blocks refer to the device memory
+    bool mapped = false;
+
+    // Statistics
+    mutable i64 hits = 0;
+    mutable i64 misses = 0;
+    mutable i64 evictions = 0;
+
     
     //
     // Initializing
@@ -109,6 +194,9 @@ public:
     
     // Caches a block (if not already cached)
     FSBlock *cache(BlockNr nr) const noexcept;
+
+    // Caches multiple blocks (consecutive blocks are read in one request)
+    void prefetch(std::span<const BlockNr> nrs) const;
     
     // Returns a pointer to a block with read permissions (maybe null)
     const FSBlock *tryFetch(BlockNr nr) const noexcept;
@@ -133,7 +221,7 @@ public:
     // Operator overload
     const FSBlock &operator[](size_t nr) const { return fetch(BlockNr(nr)); }
     
-    // Wipes out a block (makes it an empty block)
+    // Drops a block from the cache (pending changes are discarded)
     void erase(BlockNr nr);
     
     
@@ -141,13 +229,48 @@ public:
     // Caching
     //
     
-    isize cachedBlocks() const { return (isize)blocks.size(); }
+    isize cachedBlocks() const { return isize(frames.size() - freeFrames.size()); }
     isize dirtyBlocks() const { return (isize)dirty.size(); }
     void markAsDirty(BlockNr nr);
     
     void flush();
     void updateChecksums();
     void invalidate();
+
+    // Sets the maximum number of cached data blocks (at least one slab)
+    void setLimit(isize frames);
+
+    // Releases the block objects whose data has been evicted
+    void trim();
+
+    // Enters or leaves concurrent mode
+    void setConcurrent(bool value);
+
+    // Enters or leaves mapped mode
+    void setMapped(bool value);
+
+private:
+
+    // Returns the memory of a frame
+    u8 *frameAddr(isize f) const { return slabs[f / slabSize].get() + (f % slabSize) * bsize(); }
+
+    // Manages the LRU list
+    void link(isize f) const;
+    void unlink(isize f) const;
+
+    // Provides an unused frame
+    isize acquireFrame() const;
+
+    // Loads or releases the data of a block
+    void load(FSBlock &block) const;
+    void release(FSBlock &block) const;
+
+    // Moves the data of a mapped block into a frame
+    void materialize(FSBlock &block) const;
+
+    // Reads or writes block data (bypassing the frames)
+    void read(u8 *dst, BlockNr nr) const;
+    void write(const u8 *src, BlockNr nr);
 };
 
 }
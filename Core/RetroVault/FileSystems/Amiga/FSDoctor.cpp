@@ -12,6 +12,7 @@
 #include "FileSystems/Amiga/FileSystem.h"
 #include "utl/io.h"
 #include "utl/support.h"
+#include "utl/concurrency/Worker.h"
 #include <unordered_map>
 #include <unordered_set>
 #include <sstream>
@@ -30,35 +31,35 @@ if ((u32)value > (u32)exp) \
 { expected = (u8)(exp); return FSBlockError::EXPECTED_SMALLER_VALUE; } }
 
 #define EXPECT_REF { \
-if (!fs.block(value)) return FSBlockError::EXPECTED_REF; }
+if (isize(value) >= traits.blocks) return FSBlockError::EXPECTED_REF; }
 
 #define EXPECT_SELFREF { \
-if ((u32)value != (u32)ref) { expected = ref; return FSBlockError::EXPECTED_SELFREF; } }
+if ((u32)value != (u32)node.nr) { expected = node.nr; return FSBlockError::EXPECTED_SELFREF; } }
 
 #define EXPECT_FILEHEADER_REF { \
-if (!fs.is(value, FSBlockType::FILEHEADER)) { \
+if (!is(value, FSBlockType::FILEHEADER)) { \
 return FSBlockError::EXPECTED_FILE_HEADER_BLOCK; } }
 
 #define EXPECT_HASH_REF { \
-if (!fs.is(value, FSBlockType::FILEHEADER) && !fs.is(value, FSBlockType::USERDIR)) { \
+if (!is(value, FSBlockType::FILEHEADER) && !is(value, FSBlockType::USERDIR)) { \
 return FSBlockError::EXPECTED_HASHABLE_BLOCK; } }
 
 #define EXPECT_OPTIONAL_HASH_REF { \
 if (value) { EXPECT_HASH_REF } }
 
 #define EXPECT_PARENT_DIR_REF { \
-if (!fs.is(value, FSBlockType::ROOT) && !fs.is(value, FSBlockType::USERDIR)) { \
+if (!is(value, FSBlockType::ROOT) && !is(value, FSBlockType::USERDIR)) { \
 return FSBlockError::EXPECTED_USERDIR_OR_ROOT; } }
 
 #define EXPECT_FILELIST_REF { \
-if (!fs.is(value, FSBlockType::FILELIST)) { \
+if (!is(value, FSBlockType::FILELIST)) { \
 return FSBlockError::EXPECTED_FILE_LIST_BLOCK; } }
 
 #define EXPECT_OPTIONAL_FILELIST_REF { \
 if (value) { EXPECT_FILELIST_REF } }
 
 #define EXPECT_BITMAP_REF(nr) { \
-if (!fs.is(value, FSBlockType::BITMAP)) { \
+if (!is(value, FSBlockType::BITMAP)) { \
 if (fs.getBmBlocks().size() > usize(nr)) { expected = fs.getBmBlocks()[nr]; } \
 return FSBlockError::EXPECTED_BITMAP_BLOCK; } }
 
@@ -66,14 +67,14 @@ return FSBlockError::EXPECTED_BITMAP_BLOCK; } }
 if (value) { EXPECT_BITMAP_REF(nr) } }
 
 #define EXPECT_BITMAP_EXT_REF { \
-if (!fs.is(value, FSBlockType::BITMAP_EXT)) { \
+if (!is(value, FSBlockType::BITMAP_EXT)) { \
 return FSBlockError::EXPECTED_BITMAP_EXT_BLOCK; } }
 
 #define EXPECT_OPTIONAL_BITMAP_EXT_REF { \
 if (value) { EXPECT_BITMAP_EXT_REF } }
 
 #define EXPECT_DATABLOCK_REF { \
-if (traits.ofs() && !fs.is(value, FSBlockType::DATA_OFS)) { \
+if (traits.ofs() && !is(value, FSBlockType::DATA_OFS)) { \
 return FSBlockError::EXPECTED_DATA_BLOCK; } }
 
 #define EXPECT_OPTIONAL_DATABLOCK_REF { \
@@ -266,27 +267,111 @@ FSDoctor::xray(bool strict)
 isize
 FSDoctor::xray(bool strict, std::ostream &os, bool verbose)
 {
+    return xray(strict, os, verbose, 1);
+}
+
+isize
+FSDoctor::xray(bool strict, std::ostream &os, bool verbose, isize threads)
+{
+    if (threads <= 0) threads = std::max(1U, std::thread::hardware_concurrency());
+
+    isize blocks = traits.blocks;
+
     diagnosis.blockErrors = {};
+    diagnosis.blockTypes.assign(blocks, FSBlockType::UNKNOWN);
+
+    // Invalidate the type table of the previous scan
+    diagnosis.generation = -1;
 
-    for (BlockNr nr = 0; isize(nr) < traits.blocks; nr++) {
+    // Record all block types first to resolve references without the cache
+    for (isize first = 0; first < blocks; first += threads * chunkSize) {
 
-        if (auto errors = xray(nr, strict)) {
+        fs.trim();
+        for (isize nr = first; nr < std::min(first + threads * chunkSize, blocks); nr++) {
+            diagnosis.blockTypes[nr] = fs.fetch(BlockNr(nr)).type;
+        }
+    }
+    diagnosis.generation = fs.getGeneration();
+
+    // The blocks of the current round (fetched before the workers start)
+    std::vector<const FSBlock *> round;
+    std::vector<bool> allocated;
+    isize base = 0;
+
+    // Scans a range of blocks, recording block types and erroneous blocks
+    auto scan = [&](isize first, std::vector<std::pair<BlockNr, isize>> &errors) {
 
-            if (verbose) {
+        errors.clear();
+        for (isize nr = first; nr < std::min(first + chunkSize, blocks); nr++) {
 
-                if (!diagnosis.blockErrors.empty()) os << std::endl;
-                xray(nr, strict, os);
+            auto &node = *round[nr - base];
 
-            } else {
+            // Free blocks may hold stale data that is no longer part of the volume
+            if (!allocated[nr - base]) continue;
+
+            if (auto count = xray(node, strict)) errors.push_back({ BlockNr(nr), count });
+        }
+    };
 
-                os << utl::tab("Block " + std::to_string(nr) + "");
-                os << errors << (errors == 1 ? " anomaly" : " anomalies") << std::endl;
+    // Each thread scans one chunk per round
+    std::vector<std::vector<std::pair<BlockNr, isize>>> results(threads);
+    std::vector<std::unique_ptr<utl::Worker>> workers;
+    for (isize i = 1; i < threads; i++) {
+        workers.push_back(std::make_unique<utl::Worker>("FSDoctor " + std::to_string(i)));
+    }
+
+    fs.setConcurrent(threads > 1);
+
+    try {
+
+        for (isize first = 0; first < blocks; first += threads * chunkSize) {
+
+            // Keep the cache bounded (no block references are held here)
+            round.clear();
+            allocated.clear();
+            fs.trim();
+
+            // Fetch all blocks of this round in a single pass
+            base = first;
+            for (isize nr = first; nr < std::min(first + threads * chunkSize, blocks); nr++) {
+                round.push_back(&fs.fetch(BlockNr(nr)));
+                allocated.push_back(allocator.isAllocated(BlockNr(nr)));
             }
 
-            diagnosis.blockErrors.push_back(BlockNr(nr));
+            for (isize i = 1; i < threads; i++) {
+                workers[i - 1]->submit([&, i, first]() { scan(first + i * chunkSize, results[i]); });
+            }
+            scan(first, results[0]);
+            for (auto &worker : workers) worker->wait();
+
+            // Report in block order
+            for (auto &errors : results) for (auto [nr, count] : errors) {
+
+                if (verbose) {
+
+                    if (!diagnosis.blockErrors.empty()) os << std::endl;
+                    xray(nr, strict, os);
+
+                } else {
+
+                    os << utl::tab("Block " + std::to_string(nr) + "");
+                    os << count << (count == 1 ? " anomaly" : " anomalies") << std::endl;
+                }
+
+                diagnosis.blockErrors.push_back(nr);
+            }
         }
+
+    } catch (...) {
+
+        for (auto &worker : workers) { try { worker->wait(); } catch (...) { } }
+        fs.setConcurrent(false);
+        throw;
     }
 
+    fs.setConcurrent(false);
+    fs.trim();
+
     return isize(diagnosis.blockErrors.size());
 }
 
@@ -369,13 +454,18 @@ FSDoctor::xrayBitmap(std::ostream &os, bool strict)
 isize
 FSDoctor::xray(BlockNr ref, bool strict) const
 {
-    auto &node = fs.fetch(ref);
+    return xray(fs.fetch(ref), strict);
+}
+
+isize
+FSDoctor::xray(const FSBlock &node, bool strict) const
+{
     isize count = 0;
 
     for (isize i = 0; i < node.bsize(); i += 4) {
 
         std::optional<u32> expected;
-        if (auto error = xray32(ref, i, strict, expected); error != FSBlockError::OK) {
+        if (auto error = xray32(node, i, strict, expected); error != FSBlockError::OK) {
             count++;
         }
     }
@@ -386,19 +476,29 @@ FSDoctor::xray(BlockNr ref, bool strict) const
 FSBlockError
 FSDoctor::xray8(BlockNr ref, isize pos, bool strict, optional<u8> &expected) const
 {
-    // auto &node = fs.fetch(ref);
+    return xray8(fs.fetch(ref), pos, strict, expected);
+}
+
+FSBlockError
+FSDoctor::xray8(const FSBlock &node, isize pos, bool strict, optional<u8> &expected) const
+{
     optional<u32> exp;
-    auto result = xray32(ref, pos & ~3, strict, exp);
+    auto result = xray32(node, pos & ~3, strict, exp);
     if (exp) expected = GET_BYTE(*exp, 3 - (pos & 3));
     return result;
 }
 
 FSBlockError
 FSDoctor::xray32(BlockNr ref, isize pos, bool strict, optional<u32> &expected) const
+{
+    return xray32(fs.fetch(ref), pos, strict, expected);
+}
+
+FSBlockError
+FSDoctor::xray32(const FSBlock &node, isize pos, bool strict, optional<u32> &expected) const
 {
     assert(pos % 4 == 0);
 
-    auto& node = fs.fetch(ref);
     isize word = pos / 4;
     isize sword = word - (node.bsize() / 4);
     BlockNr value = node.get32(word);
@@ -407,7 +507,7 @@ FSDoctor::xray32(BlockNr ref, isize pos, bool strict, optional<u32> &expected) c
 
         case FSBlockType::BOOT:
 
-            if (ref == 0) {
+            if (node.nr == 0) {
 
                 constexpr u32 DOS = u32('D') << 24 | u32('O') << 16 | u32('S') << 8;
 
@@ -631,7 +731,7 @@ FSDoctor::xray(BlockNr ref, bool strict, std::ostream &os) const
 
         optional<u32> expected;
 
-        if (auto fault = xray32(ref, i, strict, expected); fault != FSBlockError::OK) {
+        if (auto fault = xray32(node, i, strict, expected); fault != FSBlockError::OK) {
 
             auto *data = node.data();
             auto type = fs.typeOf(node.nr, i);
@@ -682,7 +782,7 @@ FSDoctor::rectify(BlockNr ref, bool strict)
 
         optional<u32> expected;
 
-        if (auto fault = xray32(ref, i, strict, expected); fault != FSBlockError::OK) {
+        if (auto fault = xray32(node, i, strict, expected); fault != FSBlockError::OK) {
 
             if (expected) {
 
@@ -743,7 +843,7 @@ FSDoctor::createUsageMap(u8 *buffer, isize len) const
     // Mark all used blocks
     for (isize i = 0; i < max; i++) {
 
-        if (auto type = fs.typeOf(BlockNr(i)); type != FSBlockType::EMPTY) {
+        if (auto type = typeOf(BlockNr(i)); type != FSBlockType::EMPTY) {
 
             auto val = u8(type);
             auto pos = i * (len - 1) / (max - 1);
@@ -775,7 +875,7 @@ FSDoctor::createAllocationMap(u8 *buffer, isize len) const
     // Mark all used blocks
     for (isize i = 0; i < max; i++) {
 
-        if (auto type = fs.typeOf(BlockNr(i)); type != FSBlockType::EMPTY) {
+        if (auto type = typeOf(BlockNr(i)); type != FSBlockType::EMPTY) {
             buffer[i * (len - 1) / (max - 1)] = 1;
         }
     }
@@ -806,7 +906,7 @@ FSDoctor::createHealthMap(u8 *buffer, isize len) const
     // Mark all used blocks
     for (isize i = 0; i < max; i++) {
 
-        if (auto type = fs.typeOf(BlockNr(i)); type != FSBlockType::EMPTY) {
+        if (auto type = typeOf(BlockNr(i)); type != FSBlockType::EMPTY) {
             buffer[i * (len - 1) / (max - 1)] = 1;
         }
     }
@@ -836,4 +936,19 @@ FSDoctor::nextBlockOfType(FSBlockType type, BlockNr after) const
     return -1;
 }
 
+FSBlockType
+FSDoctor::typeOf(BlockNr nr) const
+{
+    if (diagnosis.generation == fs.getGeneration() && isize(diagnosis.blockTypes.size()) == traits.blocks) {
+        return diagnosis.blockTypes[nr];
+    }
+    return fs.typeOf(nr);
+}
+
+bool
+FSDoctor::is(BlockNr nr, FSBlockType type) const
+{
+    return isize(nr) < traits.blocks && typeOf(nr) == type;
+}
+
 }
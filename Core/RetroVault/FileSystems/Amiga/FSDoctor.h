@@ -15,6 +15,9 @@ namespace retro::vault::amiga {
 
 class FSDoctor final : public FSService {
 
+    // Number of blocks scanned in a single job
+    static constexpr isize chunkSize = 4096;
+
     class FSAllocator &allocator;
 
 public:
@@ -40,17 +43,23 @@ public:
 
 public:
 
-    // Scans all blocks. Returns the number of errors. Stores details in 'diagnosis'
+    // Scans all allocated blocks. Returns the number of errors. Stores details in 'diagnosis'
     isize xray(bool strict);
     isize xray(bool strict, std::ostream &os, bool verbose);
 
+    // Scans all blocks with multiple threads (0 = one per hardware thread)
+    isize xray(bool strict, std::ostream &os, bool verbose, isize threads);
+
     // Scans a single block and returns the number of errors
     isize xray(BlockNr ref, bool strict) const;
     isize xray(BlockNr ref, bool strict, std::ostream &os) const;
+    isize xray(const FSBlock &node, bool strict) const;
 
     // Checks the integrity of a certain byte or long word in this block
     FSBlockError xray8(BlockNr ref, isize pos, bool strict, optional<u8> &expected) const;
+    FSBlockError xray8(const FSBlock &node, isize pos, bool strict, optional<u8> &expected) const;
     FSBlockError xray32(BlockNr ref, isize pos, bool strict, optional<u32> &expected) const;
+    FSBlockError xray32(const FSBlock &node, isize pos, bool strict, optional<u32> &expected) const;
 
     // Checks the allocation table. Returns the number of errors. Stores details in 'diagnosis'
     isize xrayBitmap(bool strict = false);
@@ -86,6 +95,14 @@ public:
 
     // Searches the block list for a block of a specific type
     isize nextBlockOfType(FSBlockType type, BlockNr after) const;
+
+private:
+
+    // Returns the type of a block (as recorded by the latest scan if still valid)
+    FSBlockType typeOf(BlockNr nr) const;
+
+    // Checks if a block reference points to a block of a certain type
+    bool is(BlockNr nr, FSBlockType type) const;
 };
 
 }
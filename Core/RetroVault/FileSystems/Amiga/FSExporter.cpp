@@ -10,12 +10,78 @@
 #include "config.h"
 #include "FileSystems/Amiga/FileSystem.h"
 #include "utl/io.h"
+#include "utl/concurrency/Worker.h"
 #include <fstream>
 
 namespace retro::vault::amiga {
 
 using namespace utl;
 
+/* Files are exported in two stages. The calling thread walks the tree and
+ * extracts the file data, because the block cache must not be accessed from
+ * multiple threads. Host files are created and written by a pool of writer
+ * threads. Each writer owns a buffer which is refilled once its previous job
+ * has finished.
+ */
+struct FSExporter::Pipeline {
+
+    // Extracted file data (declared first to outlive the writers)
+    std::vector<Buffer<u8>> buffers;
+
+    // Writer threads
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // Index of the next writer
+    isize next = 0;
+
+    // Indicates if protection bits and dates are carried over
+    bool attributes = false;
+
+    // Directories whose attributes are applied after their contents
+    std::vector<std::pair<fs::path, FSAttr>> dirs;
+
+    Pipeline(bool attributes) : attributes(attributes) {
+
+        auto count = isize(std::max(1U, std::thread::hardware_concurrency()));
+
+        buffers.resize(count);
+        for (isize i = 0; i < count; i++) {
+            workers.push_back(std::make_unique<Worker>("FSExporter " + std::to_string(i)));
+        }
+    }
+
+    // Waits for all writers and rethrows the first error
+    void drain() {
+
+        std::exception_ptr error;
+        for (auto &worker : workers) {
+            try { worker->wait(); } catch (...) { if (!error) error = std::current_exception(); }
+        }
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+// Applies Amiga protection bits and dates to a host item (best effort)
+static void
+applyAttributes(const fs::path &path, const FSAttr &attr)
+{
+    using namespace std::chrono;
+    using fs::perms;
+
+    std::error_code ec;
+
+    // Amiga protection bits are inverted (a set bit revokes the permission)
+    auto mode = perms::none;
+    if (!(attr.prot & 0x08)) mode |= perms::owner_read | perms::group_read | perms::others_read;
+    if (!(attr.prot & 0x04)) mode |= perms::owner_write;
+    if (!(attr.prot & 0x02) || attr.isDir) mode |= perms::owner_exec | perms::group_exec | perms::others_exec;
+
+    auto t = system_clock::from_time_t(attr.ctime.time());
+    auto ft = fs::file_time_type::clock::now() + (t - system_clock::now());
+    fs::last_write_time(path, time_point_cast<fs::file_time_type::duration>(ft), ec);
+    fs::permissions(path, mode, ec);
+}
+
 void
 FSExporter::exportVolume(u8 *dst, isize size) const
 {
@@ -33,8 +99,11 @@ FSExporter::exportVolume(TrackDevice &dev) const
     if (fs.getTraits().blocks != dev.capacity())
         throw FSError(FSError::FS_WRONG_CAPACITY);
 
-    for (isize i = 0; i < traits.blocks; ++i)
+    for (isize i = 0; i < traits.blocks; ++i) {
+
         dev.writeBlock(fs.fetch(i).data(), i);
+        fs.trim();
+    }
 }
 
 void
@@ -75,6 +144,7 @@ FSExporter::exportBlocks(BlockNr first, BlockNr last, u8 *dst, isize size) const
     for (BlockNr nr = first; nr <= last; nr++) {
 
         fs.fetch(nr).exportBlock(dst + (nr - first) * traits.bsize, traits.bsize);
+        fs.trim();
     }
 
     loginfo(FS_DEBUG, "Success\n");
@@ -99,6 +169,7 @@ FSExporter::exportBlocks(BlockNr first, BlockNr last, const fs::path &path) cons
 
         auto *data = fs.fetch(i).data();
         stream.write((const char *)data, traits.bsize);
+        fs.trim();
     }
 
     if (!stream) {
@@ -107,7 +178,7 @@ FSExporter::exportBlocks(BlockNr first, BlockNr last, const fs::path &path) cons
 }
 
 void
-FSExporter::exportFiles(BlockNr nr, const fs::path &path, bool recursive, bool contents) const
+FSExporter::exportFiles(BlockNr nr, const fs::path &path, bool recursive, bool contents, bool attributes) const
 {
     auto &item = fs.fetch(nr);
     fs::path hostPath;
@@ -125,17 +196,33 @@ FSExporter::exportFiles(BlockNr nr, const fs::path &path, bool recursive, bool c
     loginfo(FS_DEBUG, "Exporting %s to %s\n", item.absName().c_str(), hostPath.string().c_str());
 
     auto newTree = fs.build(nr, { .depth = recursive ? MAX_ISIZE : 1 });
-    save(newTree, hostPath, recursive);
+    Pipeline pipe(attributes);
+
+    try {
+
+        save(newTree, hostPath, recursive, pipe);
+        pipe.drain();
+
+    } catch (...) {
+
+        // Don't leave any writer behind
+        try { pipe.drain(); } catch (...) { }
+        throw;
+    }
+
+    // Directories are stamped last, because writing their contents alters them
+    if (attributes && item.isDirectory() && !contents) pipe.dirs.push_back({ hostPath, fs.attr(nr) });
+    for (auto &[dir, attr] : pipe.dirs) applyAttributes(dir, attr);
 }
 
 void
-FSExporter::exportFiles(const fs::path &path, bool recursive, bool contents) const
+FSExporter::exportFiles(const fs::path &path, bool recursive, bool contents, bool attributes) const
 {
-    exportFiles(fs.pwd(), path, recursive, contents);
+    exportFiles(fs.pwd(), path, recursive, contents, attributes);
 }
 
 void
-FSExporter::save(const FSTree &tree, const fs::path &path, bool recursive) const
+FSExporter::save(const FSTree &tree, const fs::path &path, bool recursive, Pipeline &pipe) const
 {
     auto &node = fs.fetch(tree.nr);
 
@@ -154,7 +241,7 @@ FSExporter::save(const FSTree &tree, const fs::path &path, bool recursive) const
 
             fs::create_directories(path);
         }
-        saveDir(tree, path, recursive);
+        saveDir(tree, path, recursive, pipe);
     }
 
     if (node.isFile()) {
@@ -162,19 +249,19 @@ FSExporter::save(const FSTree &tree, const fs::path &path, bool recursive) const
         if (fs::exists(path)) {
             throw FSError(FSError::FS_EXISTS, path.string());
         }
-        saveFile(tree, path, recursive);
+        saveFile(tree, path, recursive, pipe);
     }
 }
 
 void
-FSExporter::saveDir(const FSTree &tree, const fs::path &path, bool recursive) const
+FSExporter::saveDir(const FSTree &tree, const fs::path &path, bool recursive, Pipeline &pipe) const
 {
     // Save files
     for (auto &it : tree.children) {
 
         auto &node = fs.fetch(it.nr);
         if (!node.isFile()) continue;
-        node.exportBlock(path / node.name().path());
+        saveFile(it, path / node.name().path(), recursive, pipe);
     }
 
     if (!recursive) return;
@@ -184,29 +271,45 @@ FSExporter::saveDir(const FSTree &tree, const fs::path &path, bool recursive) co
 
         auto &node = fs.fetch(it.nr);
         if (!node.isDirectory()) continue;
-        save(it, path / node.name().path(), recursive);
+
+        auto subdir = path / node.name().path();
+        save(it, subdir, recursive, pipe);
+        if (pipe.attributes) pipe.dirs.push_back({ subdir, fs.attr(it.nr) });
     }
 }
 
 void
-FSExporter::saveFile(const FSTree &tree, const fs::path &path, bool recursive) const
+FSExporter::saveFile(const FSTree &tree, const fs::path &path, bool recursive, Pipeline &pipe) const
 {
     auto &node = fs.fetch(tree.nr);
 
+    // Wait for the next writer to become available
+    auto k = pipe.next++ % isize(pipe.workers.size());
+    pipe.workers[k]->wait();
+
     // Get data
-    Buffer<u8> buffer; node.extractData(buffer);
+    auto &buffer = pipe.buffers[k];
+    node.extractData(buffer);
 
-    // Open file
-    std::ofstream stream(path, std::ios::binary);
-    if (!stream.is_open()) {
-        throw IOError(IOError::FILE_CANT_CREATE, path);
-    }
+    optional<FSAttr> attr;
+    if (pipe.attributes) attr = fs.attr(tree.nr);
 
-    // Write data
-    stream.write((const char *)buffer.ptr, buffer.size);
-    if (!stream) {
-        throw IOError(IOError::FILE_CANT_WRITE, path);
-    }
+    pipe.workers[k]->submit([&buffer, path, attr]() {
+
+        {   // Open file
+            std::ofstream stream(path, std::ios::binary);
+            if (!stream.is_open()) {
+                throw IOError(IOError::FILE_CANT_CREATE, path);
+            }
+
+            // Write data
+            stream.write((const char *)buffer.ptr, buffer.size);
+            if (!stream) {
+                throw IOError(IOError::FILE_CANT_WRITE, path);
+            }
+        }
+        if (attr) applyAttributes(path, *attr);
+    });
 }
 
 }
@@ -17,6 +17,9 @@ namespace retro::vault::amiga {
 
 class FSExporter final : public FSService {
 
+    // State of a running file export
+    struct Pipeline;
+
 public:
 
     using FSService::FSService;
@@ -38,18 +41,19 @@ public:
     void exportBlock(BlockNr nr, const fs::path &path) const;
     void exportBlocks(BlockNr first, BlockNr last, const fs::path &path) const;
 
-    // Exports the volume to a buffer
+    // Exports files and directories to the host file system. If attributes
+    // is set, protection bits and dates are carried over to the host.
     void exportFiles(BlockNr nr, const fs::path &path,
-                     bool recursive = true, bool contents = false) const;
+                     bool recursive = true, bool contents = false, bool attributes = false) const;
     void exportFiles(const fs::path &path,
-                     bool recursive = true, bool contents = false) const;
+                     bool recursive = true, bool contents = false, bool attributes = false) const;
 
 private:
 
     // Exports a tree to the host file system
-    void save(const FSTree &tree, const fs::path &path, bool recursive = true) const;
-    void saveFile(const FSTree &tree, const fs::path &path, bool recursive = true) const;
-    void saveDir(const FSTree &tree, const fs::path &path, bool recursive = true) const;
+    void save(const FSTree &tree, const fs::path &path, bool recursive, Pipeline &pipe) const;
+    void saveFile(const FSTree &tree, const fs::path &path, bool recursive, Pipeline &pipe) const;
+    void saveDir(const FSTree &tree, const fs::path &path, bool recursive, Pipeline &pipe) const;
 };
 
 }
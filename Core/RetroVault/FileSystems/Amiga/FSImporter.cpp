@@ -11,6 +11,7 @@
 #include "FileSystems/Amiga/FileSystem.h"
 #include "utl/io.h"
 #include <fstream>
+#include <unordered_set>
 
 namespace retro::vault::amiga {
 
@@ -47,6 +48,9 @@ FSImporter::importVolume(const u8 *src, isize size)
         }
     }
     
+    // The allocation bitmap has been replaced
+    fs.allocator.invalidate();
+
     // Print some debug information
     loginfo(FS_DEBUG, "Success\n");
 }
@@ -129,6 +133,254 @@ FSImporter::import(BlockNr top, const fs::directory_entry &entry, bool recursive
     }
 }
 
+void
+FSImporter::importBulk(const fs::path &path, bool recursive, bool contents)
+{
+    importBulk(fs.pwd(), path, recursive, contents);
+}
+
+void
+FSImporter::importBulk(BlockNr top, const fs::path &path, bool recursive, bool contents)
+{
+    /* Unlike import(), which creates one item after another, this function
+     * processes the host tree in three stages:
+     *
+     * 1. Scan:  The host tree is traversed and all items are recorded.
+     * 2. Plan:  Blocks are assigned to all items in directory order. Each
+     *           directory block precedes its contents and the data blocks of
+     *           a file form a contiguous run whenever possible. All blocks
+     *           are marked as allocated in a single bitmap update.
+     * 3. Write: All items are written in depth-first order. The new items
+     *           are linked into the target directory after all host files
+     *           have been read.
+     *
+     * Name clashes and missing space are detected before the volume is
+     * modified. If a host file cannot be read, the allocated blocks are
+     * released and the target directory remains untouched. Blocks that have
+     * been written back in the meantime stay on the volume as free blocks.
+     */
+    fs::directory_entry dir;
+
+    fs.require.directory(top);
+
+    // Get the directory item
+    try { dir = fs::directory_entry(path); } catch (...) {
+        throw IOError(IOError::FILE_CANT_READ, path);
+    }
+
+    // Stage 1: Scan the host tree
+    std::vector<BulkItem> items;
+
+    if (dir.is_directory() && contents) {
+
+        for (const auto& it : fs::directory_iterator(dir)) scan(items, it, recursive);
+
+    } else {
+
+        scan(items, dir, recursive);
+    }
+
+    // Make sure that all items can be created
+    for (auto &it : items) {
+        if (fs.searchdir(top, it.name)) throw FSError(FSError::FS_EXISTS, it.name.cpp_str());
+    }
+    verify(items);
+
+    // Stage 2: Collect free blocks, starting at the allocation pointer
+    auto count = requiredBlocks(items);
+
+    std::vector<BlockNr> blocks;
+    blocks.reserve(count);
+    fs.allocator.locateFree(count, blocks);
+    fs.trim();
+
+    // Assign blocks
+    auto it = blocks.cbegin();
+    plan(items, it);
+    assert(it == blocks.cend());
+
+    // Update the allocation bitmap
+    auto updateBitmap = [&](bool allocate) {
+
+        allocate ? fs.allocator.markAsAllocated(blocks) : fs.allocator.deallocateBlocks(blocks);
+        for (auto &it : fs.getBmBlocks()) fs[it].mutate().updateChecksum();
+        for (auto &it : fs.getBmExtBlocks()) fs[it].mutate().updateChecksum();
+    };
+    auto ap = fs.allocator.ap;
+    updateBitmap(true);
+    if (!blocks.empty()) fs.allocator.ap = (blocks.back() + 1) % fs.blocks();
+
+    // Stage 3: Write all blocks
+    try {
+
+        write(top, items);
+
+    } catch (...) {
+
+        // Release all blocks (no existing block refers to them yet)
+        updateBitmap(false);
+        fs.allocator.ap = ap;
+        throw;
+    }
+
+    // Link the new items into the target directory
+    for (auto &it : items) fs.link(top, it.nr);
+
+    // Verify the result
+    if constexpr (debug::FS_DEBUG) {
+
+        fs.flush();
+        fs.doctor.xray(true, std::cout, false);
+    }
+}
+
+void
+FSImporter::scan(std::vector<BulkItem> &items, const fs::directory_entry &entry, bool recursive)
+{
+    const auto name = entry.path().filename();
+
+    // Skip hidden files
+    if (string s = name.string(); !s.empty() && s[0] == '.') return;
+
+    BulkItem item { .path = entry.path(), .name = FSName(name) };
+
+    if (entry.is_regular_file()) {
+
+        item.size = isize(entry.file_size());
+
+    } else {
+
+        item.isDir = true;
+
+        for (const auto& it : fs::directory_iterator(entry)) {
+
+            if (it.is_regular_file() || recursive) scan(item.items, it, recursive);
+        }
+    }
+
+    items.push_back(std::move(item));
+}
+
+void
+FSImporter::verify(const std::vector<BulkItem> &items) const
+{
+    std::unordered_set<string> names;
+
+    for (auto &it : items) {
+
+        // Amiga file names are case-insensitive
+        if (!names.insert(utl::uppercased(it.name.cpp_str())).second) {
+            throw FSError(FSError::FS_EXISTS, it.name.cpp_str());
+        }
+        if (it.isDir) verify(it.items);
+    }
+}
+
+isize
+FSImporter::requiredBlocks(const std::vector<BulkItem> &items) const
+{
+    isize result = 0;
+
+    for (auto &it : items) {
+        result += it.isDir ? 1 + requiredBlocks(it.items) : fs.allocator.requiredBlocks(it.size);
+    }
+
+    return result;
+}
+
+void
+FSImporter::plan(std::vector<BulkItem> &items, std::vector<BlockNr>::const_iterator &it) const
+{
+    const isize refsPerBlock = (traits.bsize / 4) - 56;
+
+    for (auto &item : items) {
+
+        item.nr = *it++;
+
+        if (item.isDir) { plan(item.items, it); continue; }
+
+        auto numDataBlocks = fs.allocator.requiredDataBlocks(item.size);
+        auto numListBlocks = fs.allocator.requiredFileListBlocks(item.size);
+
+        auto takeData = [&](isize count) {
+            for (isize i = 0; i < count; i++) item.dataBlocks.push_back(*it++);
+        };
+        auto remaining = [&]() {
+            return numDataBlocks - (isize)item.dataBlocks.size();
+        };
+
+        // Use the same block order as FSAllocator::allocateFileBlocks
+        takeData(std::min(numDataBlocks, refsPerBlock));
+
+        if (traits.ofs()) {
+
+            // Header block -> Data blocks -> List block -> Data blocks ...
+            for (isize i = 0; i < numListBlocks; i++) {
+
+                item.listBlocks.push_back(*it++);
+                takeData(std::min(remaining(), refsPerBlock));
+            }
+
+        } else {
+
+            // Header block -> Data blocks -> All list blocks -> Remaining data blocks
+            for (isize i = 0; i < numListBlocks; i++) item.listBlocks.push_back(*it++);
+            takeData(remaining());
+        }
+    }
+}
+
+void
+FSImporter::write(BlockNr parent, std::vector<BulkItem> &items)
+{
+    for (auto &item : items) {
+
+        auto &node = fs.fetch(item.nr).mutate();
+        node.init(item.isDir ? FSBlockType::USERDIR : FSBlockType::FILEHEADER);
+        node.setName(item.name);
+        node.setParentDirRef(parent);
+        node.setNextHashRef(item.nextHash);
+
+        if (item.isDir) {
+
+            loginfo(FS_DEBUG, "Importing directory %s\n", item.name.c_str());
+
+            // Setup the hash table of the new directory
+            std::vector<BulkItem *> last(node.hashTableSize());
+
+            for (auto &child : item.items) {
+
+                auto hash = child.name.hashValue(traits.dos) % node.hashTableSize();
+
+                if (last[hash]) {
+                    last[hash]->nextHash = child.nr;
+                } else {
+                    node.setHashRef(hash, child.nr);
+                }
+                last[hash] = &child;
+            }
+            node.updateChecksum();
+
+            // Import all items
+            write(item.nr, item.items);
+
+        } else {
+
+            loginfo(FS_DEBUG, "  Importing file %s\n", item.path.string().c_str());
+
+            Buffer<u8> buffer(item.path);
+
+            // Reject files that have changed since the scan
+            if (buffer.size != item.size) throw IOError(IOError::FILE_CANT_READ, item.path);
+
+            fs.replace(item.nr, buffer.ptr, buffer.size, item.listBlocks, item.dataBlocks);
+        }
+
+        // Write back regularly to keep the number of dirty blocks bounded
+        if (fs.cache.dirtyBlocks() >= flushThreshold) fs.flush();
+    }
+}
+
 void
 FSImporter::importBlock(BlockNr nr, const fs::path &path)
 {
@@ -140,6 +392,7 @@ FSImporter::importBlock(BlockNr nr, const fs::path &path)
 
     auto &block = fs.fetch(nr).mutate();
     stream.read((char *)block.data(), traits.bsize);
+    fs.allocator.invalidate();
 
     if (!stream) {
         throw IOError(IOError::FILE_CANT_READ, path);
@@ -26,12 +26,49 @@ public:
     void import(const fs::path &path, bool recursive = true, bool contents = false);
     void import(BlockNr top, const fs::path &path, bool recursive = true, bool contents = false);
 
+    // Imports files and folders in a single pass (preplans all blocks)
+    void importBulk(const fs::path &path, bool recursive = true, bool contents = false);
+    void importBulk(BlockNr top, const fs::path &path, bool recursive = true, bool contents = false);
+
     // Imports a single block
     void importBlock(BlockNr nr, const fs::path &path);
 
 private:
 
     void import(BlockNr top, const fs::directory_entry &dir, bool recursive);
+
+
+    //
+    // Bulk import
+    //
+
+    // Number of dirty blocks triggering a write-back during bulk imports
+    static constexpr isize flushThreshold = 4096;
+
+    // A file or directory scheduled for a bulk import
+    struct BulkItem {
+
+        fs::path path;
+        FSName name;
+        bool isDir = false;
+        isize size = 0;
+
+        // Assigned blocks (file header or user directory block)
+        BlockNr nr = 0;
+        BlockNr nextHash = 0;
+        std::vector<BlockNr> listBlocks;
+        std::vector<BlockNr> dataBlocks;
+
+        // Directory contents
+        std::vector<BulkItem> items;
+    };
+
+    // Bulk import stages
+    void scan(std::vector<BulkItem> &items, const fs::directory_entry &entry, bool recursive);
+    void verify(const std::vector<BulkItem> &items) const;
+    isize requiredBlocks(const std::vector<BulkItem> &items) const;
+    void plan(std::vector<BulkItem> &items, std::vector<BlockNr>::const_iterator &it) const;
+    void write(BlockNr parent, std::vector<BulkItem> &items);
 };
 
 }
@@ -464,6 +464,12 @@ typedef struct
     // Bitmap errors
     std::vector<BlockNr> usedButUnallocated;
     std::vector<BlockNr> unusedButAllocated;
+
+    // Block types recorded by the latest block scan
+    std::vector<FSBlockType> blockTypes;
+
+    // File system generation at the time of the latest block scan
+    isize generation = -1;
 }
 FSDiagnosis;
 
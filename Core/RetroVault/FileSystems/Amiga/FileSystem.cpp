@@ -196,7 +196,7 @@ FileSystem::stat() const noexcept
         .bDate          = rb.getCreationDate(),
         .mDate          = rb.getModificationDate(),
 
-        .generation     = 0 // TODO
+        .generation     = generation
     };
 
     return result;
@@ -110,6 +110,8 @@ namespace retro::vault::amiga {
 class FileSystem : public Loggable {
 
     friend struct FSBlock;
+    friend class FSAllocator;
+    friend class FSImporter;
 
     // Formatting constants
     static constexpr isize bmHeaderSize = 4;
@@ -148,6 +150,10 @@ class FileSystem : public Loggable {
     // Location of the current directory
     BlockNr current = 0;
 
+    // Directory entry cache (parent block -> case-folded name -> item)
+    struct DirCacheEntry { BlockNr item; isize generation; };
+    mutable std::unordered_map<BlockNr, std::unordered_map<string, DirCacheEntry>> dirCache;
+
 
     // Service layer
 
@@ -182,6 +188,7 @@ public:
     FileSystem& operator=(FileSystem &&) = delete;
 
     void stepGeneration() { ++generation; }
+    isize getGeneration() const noexcept { return generation; }
     
 
     //
@@ -239,7 +246,7 @@ public:
     FSItemType typeOf(BlockNr nr, isize pos) const { return fetch(nr).itemType(pos); }
 
     // Convenience wrappers
-    bool is(BlockNr nr, FSBlockType type) const { return fetch(nr).is(type); }
+    bool is(BlockNr nr, FSBlockType type) const { auto *b = tryFetch(nr); return b && b->is(type); }
     bool isEmpty(BlockNr nr) const { return fetch(nr).isEmpty(); }
     bool isRoot(BlockNr nr) const { return fetch(nr).isRoot(); }
     bool isFile(BlockNr nr) const { return fetch(nr).isFile(); }
@@ -275,6 +282,18 @@ public:
     
     // Invalidates all cached blocks
     void invalidate();
+
+    // Releases evicted blocks (no block references must be held)
+    void trim() { cache.trim(); }
+
+    // Loads the data of multiple blocks ahead of time
+    void prefetch(std::span<const BlockNr> nrs) const { cache.prefetch(nrs); }
+
+    // Enables or disables read access from multiple threads
+    void setConcurrent(bool value) { cache.setConcurrent(value); }
+
+    // Enables or disables direct read access to the device memory
+    void setMapped(bool value) { cache.setMapped(value); }
     
     // Operator overload for fetch
     const FSBlock &operator[](size_t nr) { return cache.fetch(BlockNr(nr)); }
@@ -64,6 +64,8 @@ void
 FileSystem::invalidate()
 {
     cache.invalidate();
+    allocator.invalidate();
+    dirCache.clear();
 }
 
 }
@@ -20,6 +20,7 @@ FileSystem::format(FSFormat dos) {
 
     // Assign the new DOS type
     traits.dos = dos;
+    dirCache.clear();
     if (dos == FSFormat::NODOS) return;
 
     // Perform some consistency checks
@@ -83,6 +84,9 @@ FileSystem::format(FSFormat dos) {
     for (auto& ref : bmBlocks) { (*this)[ref].mutate().updateChecksum(); }
     for (auto& ref : bmExtBlocks) { (*this)[ref].mutate().updateChecksum(); }
 
+    // The bitmap has been rewritten
+    allocator.invalidate();
+
     // Set the current directory
     current = rootBlock;
 }
@@ -151,6 +155,24 @@ FileSystem::searchdir(BlockNr at, const FSName &name) const
 {
     std::unordered_set<BlockNr> visited;
 
+    // Consult the directory entry cache
+    auto key = utl::uppercased(name.cpp_str());
+    auto &entries = dirCache[at];
+
+    if (auto it = entries.find(key); it != entries.end()) {
+
+        // Entries from an earlier generation are verified before use
+        if (it->second.generation != generation) {
+
+            auto *block = tryFetch(it->second.item, { FSBlockType::USERDIR, FSBlockType::FILEHEADER });
+            if (block && block->getParentDirRef() == at && block->isNamed(name)) {
+                it->second.generation = generation;
+            }
+        }
+        if (it->second.generation == generation) return it->second.item;
+        entries.erase(it);
+    }
+
     // Only proceed if a hash table is present
     auto &top = fetch(at);
     if (!top.hasHashTable()) return {};
@@ -165,7 +187,11 @@ FileSystem::searchdir(BlockNr at, const FSName &name) const
         auto *block = tryFetch(ref, { FSBlockType::USERDIR, FSBlockType::FILEHEADER });
         if (block == nullptr) break;
 
-        if (block->isNamed(name)) return block->nr;
+        if (block->isNamed(name)) {
+
+            entries[key] = { block->nr, generation };
+            return block->nr;
+        }
 
         visited.insert(ref);
         ref = block->getNextHashRef();
@@ -187,6 +213,9 @@ FileSystem::mkdir(BlockNr at, const FSName &name)
     fetch(udb).mutate().updateChecksum();
     addToHashTable(at, udb);
 
+    // Remember the new entry
+    dirCache[at][utl::uppercased(name.cpp_str())] = { udb, generation };
+
     return udb;
 }
 
@@ -195,8 +224,9 @@ FileSystem::rmdir(BlockNr at)
 {
     require.emptyDirectory(at);
 
-    deleteFromHashTable(at);
+    unlink(at);
     reclaim(at);
+    dirCache.erase(at);
 }
 
 vector<BlockNr>
@@ -240,6 +270,9 @@ FileSystem::link(BlockNr at, BlockNr fhb)
     // Wire up
     fhbBlk.mutate().setParentDirRef(at);
     addToHashTable(at, fhb);
+
+    // Remember the new entry
+    dirCache[at][utl::uppercased(fhbBlk.cppName())] = { fhb, generation };
 }
 
 void
@@ -247,6 +280,12 @@ FileSystem::unlink(BlockNr node)
 {
     require.fileOrDirectory(node);
 
+    // Forget the directory entry
+    auto &block = fetch(node);
+    if (auto it = dirCache.find(block.getParentDirRef()); it != dirCache.end()) {
+        it->second.erase(utl::uppercased(block.cppName()));
+    }
+
     // Unwire
     deleteFromHashTable(node);
 }
@@ -569,7 +608,7 @@ FileSystem::addData(BlockNr nr, const u8 *buf, isize size)
         case FSBlockType::DATA_OFS:
 
             count = std::min(traits.bsize - 24, size);
-            std::memcpy(block.data() + 24, buf, count);
+            block.setBytes(24, buf, count);
             block.setDataBytesInBlock((u32)count);
             block.updateChecksum();
             break;
@@ -577,7 +616,7 @@ FileSystem::addData(BlockNr nr, const u8 *buf, isize size)
         case FSBlockType::DATA_FFS:
 
             count = std::min(traits.bsize, size);
-            std::memcpy(block.data(), buf, count);
+            block.setBytes(0, buf, count);
             break;
 
         default:
@@ -595,7 +634,7 @@ FileSystem::reclaim(BlockNr fhb)
     if (node.isDirectory()) {
 
         // Remove user directory block
-        allocator.markAsFree(node.nr); cache.erase(node.nr);
+        allocator.deallocateBlock(node.nr);
 
     } else if (node.isFile()) {
 
@@ -604,9 +643,9 @@ FileSystem::reclaim(BlockNr fhb)
         auto listBlocks = collectListBlocks(node.nr);
 
         // Remove all blocks
-        allocator.markAsFree(node.nr); cache.erase(node.nr);
-        for (auto &it : dataBlocks) { allocator.markAsFree(it); cache.erase(it); }
-        for (auto &it : listBlocks) { allocator.markAsFree(it); cache.erase(it); }
+        dataBlocks.push_back(node.nr);
+        dataBlocks.insert(dataBlocks.end(), listBlocks.begin(), listBlocks.end());
+        allocator.deallocateBlocks(dataBlocks);
     }
 }
 
@@ -655,9 +694,9 @@ FileSystem::collect(const BlockNr nr, BlockIterator succ) const
 std::vector<const FSBlock *>
 FileSystem::collectDataBlocks(const FSBlock &node) const
 {
-    // Gather all blocks containing data block references
+    // Gather all blocks containing data block references (in file order)
     auto blocks = collectListBlocks(node);
-    blocks.push_back(&node);
+    blocks.insert(blocks.begin(), &node);
 
     // Setup the result vector
     std::vector<const FSBlock *> result;
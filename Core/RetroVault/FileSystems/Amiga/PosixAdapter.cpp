@@ -8,6 +8,7 @@
 // -----------------------------------------------------------------------------
 
 #include "FileSystems/Amiga/PosixAdapter.h"
+#include <utility>
 
 namespace retro::vault::amiga {
 
@@ -36,6 +37,32 @@ PosixAdapter::ensureMeta(HandleRef ref)
     return ensureMeta(getHandle(ref).node);
 }
 
+const std::vector<BlockNr> &
+PosixAdapter::ensureExtents(BlockNr nr)
+{
+    require.file(nr);
+
+    auto &info = ensureMeta(nr);
+
+    if (info.generation != fs.getGeneration()) {
+
+        auto collect = [&](const FSBlock &block) {
+
+            isize num = std::min(block.getNumDataBlockRefs(), block.getMaxDataBlockRefs());
+            for (isize i = 0; i < num; i++) info.extents.push_back(block.getDataBlockRef(i));
+        };
+
+        // Crawl through the file header block and all file list blocks
+        info.extents.clear();
+        collect(fs.fetch(nr));
+        for (auto &it : fs.collectListBlocks(nr)) collect(fs.fetch(it));
+
+        info.generation = fs.getGeneration();
+    }
+
+    return info.extents;
+}
+
 FSPosixStat
 PosixAdapter::stat() const noexcept
 {
@@ -344,24 +371,49 @@ PosixAdapter::resize(const fs::path &path, isize size)
 isize
 PosixAdapter::read(HandleRef ref, std::span<u8> buffer)
 {
-    auto &handle = getHandle(ref);
-    auto &node   = fs.fetch(handle.node);
-    auto &meta   = ensureMeta(node.nr);
-
-    // Cache the file if necessary
-    if (meta.cache.empty()) { node.extractData(meta.cache); }
+    auto &handle  = getHandle(ref);
+    auto &extents = ensureExtents(handle.node);
+    auto fileSize = isize(fs.fetch(handle.node).getFileSize());
 
     // Check for EOF
-    if (handle.offset >= meta.cache.size) return 0;
+    if (handle.offset >= fileSize) return 0;
 
     // Compute the number of bytes to read
-    auto count = std::min(meta.cache.size - handle.offset, (isize)buffer.size());
+    auto count = std::min(fileSize - handle.offset, (isize)buffer.size());
 
-    // Copy the requested range
-    std::memcpy(buffer.data(), meta.cache.ptr + handle.offset, count);
+    // OFS data blocks start with a header, FFS data blocks contain raw data
+    auto ofs    = fs.getTraits().ofs();
+    auto dsize  = ofs ? fs.bsize() - 24 : fs.bsize();
+    auto header = ofs ? 24 : 0;
+
+    // Read ahead if the file is read sequentially
+    if (handle.offset == handle.next) {
+
+        auto first = std::min(handle.offset / dsize, isize(extents.size()));
+        auto last  = std::min((handle.offset + count - 1) / dsize + 1 + readAhead, isize(extents.size()));
+        fs.prefetch(std::span(extents).subspan(first, last - first));
+    }
+
+    // Copy the requested range block by block
+    for (isize done = 0; done < count;) {
+
+        auto pos = handle.offset + done;
+        auto i   = pos / dsize;
+        auto off = pos % dsize;
+        auto num = std::min(dsize - off, count - done);
+
+        if (auto *block = i < isize(extents.size()) ? fs.tryFetch(extents[i]) : nullptr;
+            block && block->isData()) {
+            std::memcpy(buffer.data() + done, std::as_const(*block).data() + header + off, num);
+        } else {
+            std::memset(buffer.data() + done, 0, num);
+        }
+        done += num;
+    }
 
     // Advance the handle offset
     handle.offset += count;
+    handle.next = handle.offset;
 
     return count;
 }
@@ -372,27 +424,46 @@ PosixAdapter::write(HandleRef ref, std::span<const u8> buffer)
     if (wp) throw FSError(FSError::FS_READ_ONLY);
 
     auto &handle = getHandle(ref);
-    auto &meta   = ensureMeta(handle.node);
+    auto count   = isize(buffer.size());
+    auto end     = handle.offset + count;
 
-    // Cache the file if necessary
-    if (meta.cache.empty()) { fs.fetch(handle.node).extractData(meta.cache); }
+    // Grow the file if necessary (pads with 0)
+    require.file(handle.node);
+    if (end > isize(fs.fetch(handle.node).getFileSize())) fs.resize(handle.node, end);
 
-    // Determine the new file size
-    auto newSize = std::max(meta.cache.size, handle.offset + (isize)buffer.size());
+    auto &extents = ensureExtents(handle.node);
 
-    // Resize the cached file if necessary (pad with 0)
-    meta.cache.resize(newSize, 0);
+    // OFS data blocks start with a header, FFS data blocks contain raw data
+    auto ofs    = fs.getTraits().ofs();
+    auto dsize  = ofs ? fs.bsize() - 24 : fs.bsize();
+    auto header = ofs ? 24 : 0;
 
-    // Compute the number of bytes to write
-    auto count = buffer.size();
+    // Only rewrite the touched data blocks
+    for (isize done = 0; done < count;) {
 
-    // Update data
-    std::memcpy(meta.cache.ptr + handle.offset, buffer.data(), count);
+        auto pos = handle.offset + done;
+        auto i   = pos / dsize;
+        auto off = pos % dsize;
+        auto num = std::min(dsize - off, count - done);
 
-    // Write back
-    fs.replace(handle.node, meta.cache);
+        if (i < isize(extents.size())) {
 
-    return isize(count);
+            auto &block = fs.fetch(extents[i]).mutate();
+
+            if (block.type == FSBlockType::EMPTY && !ofs) block.init(FSBlockType::DATA_FFS);
+            if (block.isData()) {
+
+                block.setBytes(header + off, buffer.data() + done, num);
+                if (ofs) block.updateChecksum();
+            }
+        }
+        done += num;
+    }
+
+    // Overwriting data blocks keeps the extent map intact
+    ensureMeta(handle.node).generation = fs.getGeneration();
+
+    return count;
 }
 
 void
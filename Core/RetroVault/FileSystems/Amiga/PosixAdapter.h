@@ -25,8 +25,11 @@ struct NodeMeta {
     // All open handles referencing this node
     std::unordered_set<HandleRef> openHandles;
 
-    // File cache
-    Buffer<u8> cache;
+    // Data blocks in file order
+    std::vector<BlockNr> extents;
+
+    // File system generation the extent map belongs to
+    isize generation = -1;
 
     // Returns the number of open handles
     isize openCount() { return (isize)openHandles.size(); };
@@ -34,6 +37,9 @@ struct NodeMeta {
 
 class PosixAdapter : public PosixView {
 
+    // Number of blocks read ahead when a file is read sequentially
+    static constexpr isize readAhead = 32;
+
     // Write protection flag
     bool wp = false;
     
@@ -95,6 +101,9 @@ private:
     NodeMeta &ensureMeta(const FSBlock &block) { return ensureMeta(block.nr); }
     NodeMeta &ensureMeta(HandleRef ref);
 
+    // Returns the extent map of a file (rebuilt if the file system changed)
+    const std::vector<BlockNr> &ensureExtents(BlockNr nr);
+
 
     //
     // Working with directories
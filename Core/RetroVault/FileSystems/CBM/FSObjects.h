@@ -119,6 +119,13 @@ public:
 
     const char *c_str() const noexcept { return asc; }
     string str() const noexcept { return string(asc); }
+
+    // Returns the PETSCII characters in front of the padding
+    string petscii() const noexcept
+    {
+        isize i = 0; while (i < len && pet[i] != pad) i++;
+        return string((const char *)pet, i);
+    }
 };
 
 struct FSString {
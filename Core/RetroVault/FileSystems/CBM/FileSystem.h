@@ -128,6 +128,13 @@ class FileSystem : public Loggable {
     FSAllocator allocator = FSAllocator(*this);
 
 
+    // Directory layer
+
+    // Directory entry cache (PETSCII name -> entry and its directory slot)
+    struct DirCacheEntry { FSDirEntry entry; BlockNr block; isize slot; isize generation; };
+    mutable std::unordered_map<string, DirCacheEntry> dirCache;
+
+
     // Service layer
 
 public:
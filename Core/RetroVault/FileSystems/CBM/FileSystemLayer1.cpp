@@ -79,6 +79,7 @@ void
 FileSystem::invalidate()
 {
     cache.invalidate();
+    dirCache.clear();
 }
 
 }
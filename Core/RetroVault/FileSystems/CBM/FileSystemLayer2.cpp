@@ -19,6 +19,7 @@ FileSystem::format(FSFormat dos) {
 
     // Assign the new DOS type
     traits.dos = dos;
+    dirCache.clear();
     if (dos == FSFormat::NODOS) return;
 
     // Perform some consistency checks
@@ -111,10 +112,39 @@ FileSystem::setName(const PETName<16> &name)
 optional<FSDirEntry>
 FileSystem::searchDir(const PETName<16> &name) const
 {
-    for (auto &entry: readDir()) {
+    auto key = name.petscii();
+
+    // Consult the directory entry cache
+    if (auto it = dirCache.find(key); it != dirCache.end()) {
+
+        auto &cached = it->second;
+
+        // Entries from an earlier generation are reread from their slot
+        if (cached.generation != generation) {
+
+            auto entry = readDirBlock(cached.block)[cached.slot];
+            if (entry.getName() == name) {
+
+                cached.entry = entry;
+                cached.generation = generation;
+            }
+        }
+        if (cached.generation == generation) return cached.entry;
+        dirCache.erase(it);
+    }
+
+    for (auto block : collectDirBlocks()) {
 
-        if (entry.getName() == name)
-            return entry;
+        auto entries = readDirBlock(block);
+
+        for (isize i = 0; i < isize(entries.size()); i++) {
+
+            if (entries[i].getName() == name) {
+
+                dirCache[key] = { entries[i], block, i, generation };
+                return entries[i];
+            }
+        }
     }
     return {};
 }
@@ -135,6 +165,8 @@ FileSystem::searchDir(const FSPattern &pattern) const
 void
 FileSystem::link(const FSDirEntry &entry)
 {
+    dirCache.clear();
+
     auto dir = readDir();
 
     // Find a free slot
@@ -156,6 +188,8 @@ FileSystem::link(const FSDirEntry &entry)
 void
 FileSystem::unlink(BlockNr node)
 {
+    dirCache.clear();
+
     if (auto ts = traits.tsLink(node)) {
 
         auto dirBlocks = collectDirBlocks();
@@ -212,6 +246,8 @@ FileSystem::writeDir(const vector<FSDirEntry> &dir)
     // A directory contains up to 144 files
     if (dir.size() > 144) throw FSError(FSError::FS_OUT_OF_SPACE);
 
+    dirCache.clear();
+
     // Compute the number of required directory blocks
     auto numDirBlocks = (dir.size() + 7) / 8;
 
@@ -310,6 +346,8 @@ FileSystem::rm(const PETName<16> file)
 void
 FileSystem::rename(const PETName<16> &src, const PETName<16> &dst)
 {
+    dirCache.clear();
+
     auto dirBlocks = collectDirBlocks();
 
     for (auto &b : dirBlocks) {
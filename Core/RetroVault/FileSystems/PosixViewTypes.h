@@ -84,6 +84,7 @@ struct Handle {
     BlockNr node;       // File root node
     isize offset;       // I/O offset
     u32 flags;          // Open mode
+    isize next = 0;     // Offset of a sequential follow-up read
 };
 
 }
@@ -192,6 +192,9 @@ ADFFile::writeToFile(const fs::path &path, isize offset, isize len) const
         
     } else {
         
+        // The target may be the mapped file itself, which must not be truncated
+        const_cast<Buffer<u8> &>(data).unmap();
+
         data.write(path, offset, len);
         return data.size;
     }
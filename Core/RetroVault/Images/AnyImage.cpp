@@ -74,27 +74,14 @@ AnyImage::init(const fs::path &path)
     if (!stream)
         throw IOError(IOError::FILE_NOT_FOUND, path);
 
-    // Read file into a vector
-    stream.seekg(0, std::ios::end);
-        size_t size = stream.tellg();
-        stream.seekg(0, std::ios::beg);
+    // Map the file into memory (falls back to reading if mapping fails)
+    if (!data.map(path)) data.init(path);
 
-        std::vector<u8> buffer(size);
-
-        stream.read(reinterpret_cast<char *>(buffer.data()), size);
-
-    /*
-    std::vector<u8> buffer((std::istreambuf_iterator<char>(stream)),
-                           std::istreambuf_iterator<char>());
-    */
-    
-    if (buffer.empty())
+    if (data.empty())
         throw IOError(IOError::FILE_CANT_READ, path);
     
     this->path = path;
-
-    // Initialize image with the vector contents
-    init(buffer.data(), isize(buffer.size()));
+    didInitialize();
 }
 
 void
@@ -165,6 +152,9 @@ AnyImage::save()
 void
 AnyImage::save(const Range<BlockNr> range)
 {
+    // Opening the file truncates it, which must not happen while it is mapped
+    data.unmap();
+
     std::ofstream file(path, std::ios::binary);
     if (!file) throw IOError(IOError::FILE_CANT_WRITE, path);
     
@@ -210,6 +200,9 @@ AnyImage::writeToFile(const fs::path &path, isize offset, isize len) const
         throw IOError(IOError::FILE_IS_DIRECTORY);
     }
 
+    // The target may be the mapped file itself, which must not be truncated
+    const_cast<Buffer<u8> &>(data).unmap();
+
     std::ofstream stream(path, std::ofstream::binary);
 
     if (!stream.is_open()) {
@@ -13,14 +13,23 @@
 #include "utl/io.h"
 #include "utl/support/Strings.h"
 #include <format>
+#include <mutex>
 
 extern "C" {
 unsigned short extractDMS(const unsigned char *in, size_t inSize,
                           unsigned char **out, size_t *outSize, int verbose);
+unsigned short scanDMS(const unsigned char *in, size_t inSize,
+                       size_t *offsets, size_t maxTracks, size_t *numTracks);
+unsigned short extractDMSTracks(const unsigned char *in, size_t inSize,
+                                size_t offset, size_t count,
+                                unsigned char **out, size_t *outSize);
 }
 
 namespace retro::vault::image {
 
+// The xdms decrunchers keep their state in global variables
+static std::mutex xdmsMutex;
+
 optional<ImageInfo>
 DMSFile::about(const fs::path &path)
 {
@@ -49,6 +58,14 @@ DMSFile::describeImage() const noexcept
 void
 DMSFile::didInitialize()
 {
+    lazy ? index() : extract();
+}
+
+void
+DMSFile::extract()
+{
+    std::lock_guard<std::mutex> guard(xdmsMutex);
+
     u8* adfData = nullptr;
     size_t adfSize = 0;
 
@@ -65,4 +82,134 @@ DMSFile::didInitialize()
     if (adf.empty()) throw ImageError(ImageError::DMS_CANT_CREATE);
 }
 
+void
+DMSFile::index()
+{
+    std::vector<size_t> offsets(168);
+    size_t count = 0;
+
+    {   std::lock_guard<std::mutex> guard(xdmsMutex);
+
+        if (scanDMS(data.ptr, (size_t)data.size, offsets.data(), offsets.size(), &count) != 0 ||
+            count == 0 || force::DMS_CANT_CREATE) {
+            throw ImageError(ImageError::DMS_CANT_CREATE);
+        }
+    }
+
+    records.clear();
+
+    isize start = 0;
+    for (size_t i = 0; i < count; ++i) {
+
+        auto *th = data.ptr + offsets[i];
+
+        TrackRecord record = {
+
+            .offset  = isize(offsets[i]),
+            .start   = start,
+            .length  = isize(th[10] << 8 | th[11]),
+            .chained = (th[12] & 1) != 0
+        };
+        records.push_back(record);
+        start += record.length;
+    }
+
+    // Allocate the ADF and fill it on demand (pad to 80 cylinders like an ADF)
+    try {
+        adf.init(std::max(start, ADFFile::ADFSIZE_35_DD));
+    } catch (...) {
+        throw ImageError(ImageError::DMS_CANT_CREATE);
+    }
+    unpacked.assign(records.size(), false);
+
+    loginfo(DMS_DEBUG, "Indexed %zu tracks (%ld bytes)\n", count, start);
+}
+
+void
+DMSFile::unpack(Range<isize> bytes) const
+{
+    std::lock_guard<std::mutex> guard(mutex);
+
+    for (isize i = 0; i < isize(records.size()); ++i) {
+
+        auto &r = records[i];
+
+        if (unpacked[i]) continue;
+        if (r.start >= bytes.upper || r.start + r.length <= bytes.lower) continue;
+
+        unpackChain(i);
+    }
+}
+
+void
+DMSFile::unpackChain(isize nr) const
+{
+    // Tracks of the same chain must be unpacked in a single run, because the
+    // decrunchers are only initialized at the beginning of the chain
+    isize first = nr, last = nr;
+    while (first > 0 && records[first - 1].chained) first--;
+    while (last < isize(records.size()) - 1 && records[last].chained) last++;
+
+    loginfo(DMS_DEBUG, "Unpacking tracks %ld - %ld\n", first, last);
+
+    u8* out = nullptr;
+    size_t outSize = 0;
+    unsigned short err;
+
+    {   std::lock_guard<std::mutex> guard(xdmsMutex);
+
+        err = extractDMSTracks(data.ptr, (size_t)data.size, (size_t)records[first].offset,
+                               size_t(last - first + 1), &out, &outSize);
+    }
+
+    // Copy over all tracks that haven't been unpacked (and modified) before
+    for (isize i = first, pos = 0; i <= last; pos += records[i++].length) {
+
+        auto &r = records[i];
+
+        if (unpacked[i] || pos + r.length > isize(outSize)) continue;
+
+        memcpy(adf.data.ptr + r.start, out + pos, r.length);
+        unpacked[i] = true;
+    }
+
+    if (out) free(out);
+    if (err != 0) throw ImageError(ImageError::DMS_CANT_CREATE);
+}
+
+Range<isize>
+DMSFile::trackBytes(TrackNr t) const
+{
+    auto offset = boffset(TS{t, 0});
+    return Range<isize>{offset, offset + numSectors(t) * bsize()};
+}
+
+void
+DMSFile::readBlocks(u8 *dst, Range<isize> r) const
+{
+    unpack(Range<isize>{r.lower * bsize(), r.upper * bsize()});
+    adf.readBlocks(dst, r);
+}
+
+void
+DMSFile::writeBlocks(const u8 *src, Range<isize> r)
+{
+    unpack(Range<isize>{r.lower * bsize(), r.upper * bsize()});
+    adf.writeBlocks(src, r);
+}
+
+BitView
+DMSFile::encode(TrackNr t) const
+{
+    unpack(trackBytes(t));
+    return adf.encode(t);
+}
+
+void
+DMSFile::decode(TrackNr t, BitView bits)
+{
+    unpack(trackBytes(t));
+    adf.decode(t, bits);
+}
+
 }
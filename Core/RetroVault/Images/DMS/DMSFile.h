@@ -10,15 +10,38 @@
 #pragma once
 
 #include "ADFFile.h"
+#include <mutex>
 
 namespace retro::vault::image {
 
 class DMSFile : public FloppyDiskImage {
 
-public:
+    // Location of a data track inside the archive
+    struct TrackRecord {
+
+        isize offset;   // Position of the track header in the archive
+        isize start;    // Position of the unpacked data in the ADF
+        isize length;   // Number of bytes after unpacking
+        bool chained;   // Successor continues with the current decruncher state
+    };
+
+    // Indicates whether tracks are unpacked on first access
+    bool lazy = true;
+
+    // Track index (lazy mode only)
+    std::vector<TrackRecord> records;
 
+    // Tracks that have already been unpacked into the ADF (lazy mode only)
+    mutable std::vector<bool> unpacked;
+
+    // Guards the lazy unpacking state
+    mutable std::mutex mutex;
+
+    // The unpacked disk (only valid for tracks that have been unpacked)
     ADFFile adf;
 
+public:
+
     static optional<ImageInfo> about(const fs::path &path);
 
 
@@ -28,23 +51,30 @@ public:
 
 public:
 
-    explicit DMSFile(const fs::path &path) { init(path); }
-    explicit DMSFile(const u8 *buf, isize len) { init(buf, len); }
+    explicit DMSFile(const fs::path &path, bool lazy = true) : lazy(lazy) { init(path); }
+    explicit DMSFile(const u8 *buf, isize len, bool lazy = true) : lazy(lazy) { init(buf, len); }
 
     using AnyImage::init;
 
-    const ADFFile &getADF() const { return adf; }
+    const ADFFile &getADF() const { unpackAll(); return adf; }
 
+private:
 
-    //
-    // Methods from Hashable
-    //
+    // Unpacks the complete archive at once
+    void extract();
 
-public:
+    // Builds the track index without unpacking anything
+    void index();
 
-    u64 hash(HashAlgorithm algorithm) const noexcept override {
-        return adf.hash(algorithm);
-    }
+    // Unpacks all tracks overlapping the specified byte range of the ADF
+    void unpack(Range<isize> bytes) const;
+    void unpackAll() const { unpack(Range<isize>{0, adf.data.size}); }
+
+    // Unpacks the dependency chain the specified track belongs to (mutex held)
+    void unpackChain(isize nr) const;
+
+    // Returns the byte range of a track inside the ADF
+    Range<isize> trackBytes(TrackNr t) const;
 
 
     //
@@ -81,8 +111,8 @@ public:
 
     isize bsize() const override { return adf.bsize(); }
     isize capacity() const override { return adf.capacity(); }
-    void readBlocks(u8 *dst, Range<isize> r) const override { adf.readBlocks(dst, r); }
-    void writeBlocks(const u8 *src, Range<isize> r) override { adf.writeBlocks(src, r); };
+    void readBlocks(u8 *dst, Range<isize> r) const override;
+    void writeBlocks(const u8 *src, Range<isize> r) override;
 
 
     //
@@ -105,8 +135,8 @@ public:
     Diameter getDiameter() const noexcept override { return adf.getDiameter(); }
     Density getDensity() const noexcept override { return adf.getDensity(); }
 
-    BitView encode(TrackNr t) const override { return adf.encode(t); }
-    void decode(TrackNr t, BitView bits) override { return adf.decode(t, bits); }
+    BitView encode(TrackNr t) const override;
+    void decode(TrackNr t, BitView bits) override;
 };
 
 }
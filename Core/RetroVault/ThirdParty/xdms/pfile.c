@@ -36,6 +36,8 @@ static USHORT Unpack_Track(UCHAR *, UCHAR *, USHORT, USHORT, UCHAR, UCHAR);
 static void printbandiz(UCHAR *, USHORT);
 static void dms_decrypt(UCHAR *, USHORT);
 USHORT extractDMS(const UCHAR *in, size_t inSize, UCHAR **out, size_t *outSize, int verbose);
+USHORT scanDMS(const UCHAR *in, size_t inSize, size_t *offsets, size_t maxTracks, size_t *numTracks);
+USHORT extractDMSTracks(const UCHAR *in, size_t inSize, size_t offset, size_t count, UCHAR **out, size_t *outSize);
 
 static char modes[7][7]={"NOCOMP","SIMPLE","QUICK ","MEDIUM","DEEP  ","HEAVY1","HEAVY2"};
 static USHORT PWDCRC;
@@ -200,6 +202,118 @@ USHORT extractDMS(const UCHAR *in, size_t inSize, UCHAR **out, size_t *outSize,
     return ret;
 }
 
+// Lazy entry points for vAmiga (Dirk Hoffmann)
+//
+// scanDMS validates the archive header and records the offsets of all track
+// headers that carry disk data (the same records extractDMS would unpack).
+// No track is decompressed. extractDMSTracks unpacks 'count' of these tracks
+// starting at the track header located at 'offset'. The decrunchers are
+// initialized before the first track is processed. Hence, 'offset' must point
+// to a track that does not depend on the decruncher state of its predecessor.
+
+USHORT scanDMS(const UCHAR *in, size_t inSize, size_t *offsets, size_t maxTracks, size_t *numTracks) {
+
+    USHORT geninfo, hcrc, disktype, number, pklen1, pklen2, unpklen;
+    size_t pos;
+
+    *numTracks = 0;
+
+    if (inSize < HEADLEN) return ERR_SREAD;
+
+    /*  Check the first 4 bytes of file to see if it is "DMS!"  */
+    if ( (in[0] != 'D') || (in[1] != 'M') || (in[2] != 'S') || (in[3] != '!') ) return ERR_NOTDMS;
+
+    /* Header CRC */
+    hcrc = (USHORT)((in[HEADLEN-2]<<8) | in[HEADLEN-1]);
+    if (hcrc != CreateCRC((UCHAR *)in+4,(ULONG)(HEADLEN-6))) return ERR_HCRC;
+
+    geninfo = (USHORT) ((in[10]<<8) | in[11]);
+    disktype = (USHORT) ((in[50]<<8) | in[51]);
+
+    if (disktype == 7) return ERR_FMS;
+    if (geninfo & 2) return ERR_NOPASSWD;
+
+    for (pos = HEADLEN; pos + THLEN <= inSize; ) {
+
+        const UCHAR *th = in + pos;
+
+        /*  Trailing data that is not a track header marks the end  */
+        if ((th[0] != 'T')||(th[1] != 'R')) break;
+
+        if (CreateCRC((UCHAR *)th,(ULONG)(THLEN-2)) != (USHORT)((th[THLEN-2] << 8) | th[THLEN-1]))
+            return ERR_THCRC;
+
+        number = (USHORT)((th[2] << 8) | th[3]);
+        pklen1 = (USHORT)((th[6] << 8) | th[7]);
+        pklen2 = (USHORT)((th[8] << 8) | th[9]);
+        unpklen = (USHORT)((th[10] << 8) | th[11]);
+
+        if ((pklen1 > TRACK_BUFFER_LEN) || (pklen2 >TRACK_BUFFER_LEN) || (unpklen > TRACK_BUFFER_LEN)) return ERR_BIGTRACK;
+        if (pos + THLEN + pklen1 > inSize) return ERR_SREAD;
+
+        if (CreateCRC((UCHAR *)th+THLEN,(ULONG)pklen1) != (USHORT)((th[16] << 8) | th[17]))
+            return ERR_TDCRC;
+
+        if ((number<80) && (unpklen>2048)) {
+
+            if (*numTracks == maxTracks) return ERR_BIGTRACK;
+            offsets[(*numTracks)++] = pos;
+        }
+
+        pos += THLEN + pklen1;
+    }
+
+    return NO_PROBLEM;
+}
+
+USHORT extractDMSTracks(const UCHAR *in, size_t inSize, size_t offset, size_t count, UCHAR **out, size_t *outSize) {
+
+    USHORT ret = NO_PROBLEM;
+    size_t written = 0;
+    UCHAR *b1, *b2;
+
+    *out = NULL;
+    *outSize = 0;
+
+    assert(!outbuf);
+
+    inbuf = in;
+    insize = inSize;
+    inpos = offset;
+    outbuf = NULL;
+    outpos = 0;
+
+    b1 = (UCHAR *)calloc((size_t)TRACK_BUFFER_LEN,1);
+    b2 = (UCHAR *)calloc((size_t)TRACK_BUFFER_LEN,1);
+    text = (UCHAR *)calloc((size_t)TEMP_BUFFER_LEN,1);
+
+    if (b1 && b2 && text) {
+
+        PWDCRC = 0;
+        Init_Decrunchers();
+
+        while (count) {
+
+            if ((ret = Process_Track(b1,b2,CMD_UNPACK,0,0)) != NO_PROBLEM) break;
+            if (outpos != written) { written = outpos; count--; }
+        }
+
+    } else {
+
+        ret = ERR_NOMEMORY;
+    }
+
+    free(b1);
+    free(b2);
+    free(text);
+
+    *out = outbuf;
+    *outSize = outpos;
+    outbuf = NULL;
+
+    return ret;
+}
+
 #if 0
 USHORT Process_File(char *iname, char *oname, USHORT cmd, USHORT opt, USHORT PCRC, USHORT pwd){
     FILE *fi, *fo=NULL;
@@ -2204,6 +2204,13 @@ VAmiga::launch(const void *listener, Callback *func)
     emu->launch(listener, func);
 }
 
+void
+VAmiga::launch(const void *listener, Callback *func, Farm &farm, isize hint)
+{
+    VAMIGA_PUBLIC
+    emu->launch(listener, func, farm, hint);
+}
+
 bool
 VAmiga::isLaunched() const
 {
@@ -1890,6 +1890,19 @@ public:
      *  @param  func        The callback function.
      */
     void launch(const void *listener = nullptr, Callback *func = nullptr);
+
+    /** @brief  Launches the emulator on a farm.
+     *
+     *  Instead of launching a separate thread, the emulator is executed by
+     *  the worker threads of the provided farm. This is useful for running a
+     *  large number of emulator instances in parallel.
+     *
+     *  @param  listener    See launch(const void *, Callback *)
+     *  @param  func        See launch(const void *, Callback *)
+     *  @param  farm        The farm executing the emulator.
+     *  @param  hint        Preferred worker thread (-1 = no preference).
+     */
+    void launch(const void *listener, Callback *func, class Farm &farm, isize hint = -1);
     
     /** @brief  Returns true if the emulator has been launched.
      */
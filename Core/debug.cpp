@@ -109,6 +109,7 @@ DEBUG_CHANNEL(DSKREG_DEBUG,     "Disk controller registers");
 DEBUG_CHANNEL(DSK_DEBUG,        "Disk controller execution");
 DEBUG_CHANNEL(MFM_DEBUG,        "Disk encoder / decoder");
 DEBUG_CHANNEL(FS_DEBUG,         "File System Classes (OFS / FFS)");
+DEBUG_CHANNEL(FS_CHECKSUM,      "Verify incremental block checksums");
 
 // Hard Drives
 DEBUG_CHANNEL(HDR_ACCEPT_ALL,   "Disables hard drive layout checks");
@@ -101,6 +101,7 @@ constexpr long DSKREG_DEBUG       = 0;
 constexpr long DSK_DEBUG          = 0;
 constexpr long MFM_DEBUG          = 0;
 constexpr long FS_DEBUG           = 0;
+constexpr long FS_CHECKSUM        = 0;
 
 // Hard Drives
 constexpr long HDR_ACCEPT_ALL     = 0;
@@ -288,6 +289,7 @@ extern long DSKREG_DEBUG;
 extern long DSK_DEBUG;
 extern long MFM_DEBUG;
 extern long FS_DEBUG;
+extern long FS_CHECKSUM;
 
 // Hard Drives
 extern long HDR_ACCEPT_ALL;
@@ -9,3 +9,5 @@
 
 #include "chrono/Time.h"
 #include "chrono/Clock.h"
+#include "chrono/Histogram.h"
+#include "chrono/Tracer.h"
@@ -0,0 +1,65 @@
+// -----------------------------------------------------------------------------
+// This file is part of utlib - A lightweight utility library
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the Mozilla Public License v2
+//
+// See https://mozilla.org/MPL/2.0 for license information
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "utl/chrono/Time.h"
+#include <array>
+#include <atomic>
+
+namespace utl {
+
+/* A histogram for time measurements with a fixed set of buckets. Recording a
+ * value is lock-free and may happen concurrently to reading the histogram
+ * from another thread.
+ */
+class Histogram {
+
+public:
+
+    // Upper bounds of all buckets in microseconds (plus an overflow bucket)
+    static constexpr std::array<i64, 16> bounds = {
+
+        10, 25, 50, 100, 250, 500, 1000, 2000, 4000, 8000,
+        16667, 20000, 33333, 50000, 100000, 250000
+    };
+
+    static constexpr isize numBuckets = isize(bounds.size()) + 1;
+
+private:
+
+    std::array<std::atomic<i64>, numBuckets> buckets {};
+    std::atomic<i64> total = 0;
+    std::atomic<i64> sum = 0;
+    std::atomic<i64> maximum = 0;
+
+public:
+
+    // Records a single measurement
+    void record(Time value);
+
+    // Discards all measurements
+    void clear();
+
+    // Returns the number of measurements in a bucket
+    i64 bucket(isize nr) const { return buckets[nr].load(std::memory_order_relaxed); }
+
+    // Returns the upper bound of a bucket in seconds (infinity for the last)
+    static double bound(isize nr);
+
+    // Returns the number of measurements and their sum and maximum
+    i64 count() const { return total.load(std::memory_order_relaxed); }
+    Time getSum() const { return Time(sum.load(std::memory_order_relaxed)); }
+    Time getMax() const { return Time(maximum.load(std::memory_order_relaxed)); }
+
+    // Estimates a quantile (0.0 ... 1.0) by interpolating inside a bucket
+    Time quantile(double q) const;
+};
+
+}
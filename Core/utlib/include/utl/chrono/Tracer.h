@@ -0,0 +1,85 @@
+// -----------------------------------------------------------------------------
+// This file is part of utlib - A lightweight utility library
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the Mozilla Public License v2
+//
+// See https://mozilla.org/MPL/2.0 for license information
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "utl/chrono/Time.h"
+#include <atomic>
+#include <ostream>
+
+namespace utl {
+
+/* The tracer records time spans in the Chrome trace-event format, which can be
+ * viewed in chrome://tracing or the Perfetto UI. Each thread writes into its
+ * own ring buffer. Recording a span is lock-free and costs a single branch if
+ * tracing is disabled. When a buffer is full, the oldest spans are discarded.
+ */
+class Tracer {
+
+public:
+
+    // A single span
+    struct Event {
+
+        const char *category;
+        const char *name;
+        i64 begin;
+        i64 end;
+    };
+
+    // Number of spans kept per thread
+    static constexpr isize capacity = 1 << 17;
+
+private:
+
+    static std::atomic<bool> enabled;
+    static std::atomic<i64> origin;
+
+public:
+
+    // Starts or stops recording (starting discards all previous spans)
+    static void start();
+    static void stop();
+    static bool isTracing() { return enabled.load(std::memory_order_relaxed); }
+
+    // Assigns a name to the calling thread
+    static void setThreadName(const string &name);
+
+    // Records a span for the calling thread
+    static void record(const char *category, const char *name, Time begin, Time end);
+
+    // Returns the number of recorded spans
+    static isize count();
+
+    // Exports all recorded spans as JSON
+    static void save(std::ostream &os);
+    static void save(const fs::path &path);
+};
+
+// Records a span covering the lifetime of this object
+class TraceSpan {
+
+    const char *category;
+    const char *name;
+    Time begin;
+
+public:
+
+    TraceSpan(const char *category, const char *name) : category(category), name(name) {
+
+        if (Tracer::isTracing()) begin = Time::now();
+    }
+
+    ~TraceSpan() {
+
+        if (begin.asNanoseconds()) Tracer::record(category, name, begin, Time::now());
+    }
+};
+
+}
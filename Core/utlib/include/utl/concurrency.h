@@ -9,5 +9,6 @@
 
 #include "concurrency/ReentrantMutex.h"
 #include "concurrency/AutoMutex.h"
+#include "concurrency/Worker.h"
 #include "abilities/Synchronizable.h"
 #include "abilities/Wakeable.h"
@@ -0,0 +1,58 @@
+// -----------------------------------------------------------------------------
+// This file is part of utlib - A lightweight utility library
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the Mozilla Public License v2
+//
+// See https://mozilla.org/MPL/2.0 for license information
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "utl/common.h"
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace utl {
+
+/* A worker is a thread that executes one job at a time in the background.
+ * Exceptions thrown by a job are caught and rethrown by wait().
+ */
+class Worker
+{
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cond;
+
+    // The pending job
+    std::function<void()> job;
+
+    // The exception thrown by the latest job
+    std::exception_ptr error;
+
+    bool busy = false;
+    bool stopping = false;
+
+public:
+
+    Worker(const string &name);
+    ~Worker();
+
+    // Starts a job (the previous job must have finished)
+    void submit(std::function<void()> job);
+
+    // Waits until the current job has finished
+    void wait();
+
+    // Checks if a job is being executed
+    bool isBusy();
+
+private:
+
+    void main(const string &name);
+};
+
+}
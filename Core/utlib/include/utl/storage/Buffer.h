@@ -26,6 +26,9 @@ template <class T> struct Buffer : public Hashable, public Dumpable {
     T *ptr;
     isize size;
     T **managed;
+
+    // Indicates if ptr refers to a private file mapping
+    bool mapped = false;
         
     Buffer() : ptr(nullptr), size(0), managed(nullptr) { }
     Buffer(T **managed) : ptr(nullptr), size(0), managed(managed) { *managed = nullptr; }
@@ -89,6 +92,16 @@ template <class T> struct Buffer : public Hashable, public Dumpable {
     void alloc(isize elements);
     void dealloc();
 
+    // Maps a file into memory. Pages are copied on first write and changes
+    // never reach the file. Returns false if the file cannot be mapped. Pages
+    // that have not been written to reflect changes other processes make to
+    // the file, and truncating the file invalidates them. Hence, the buffer
+    // must be unmapped before the mapped file is written to.
+    bool map(const fs::path &path);
+
+    // Replaces a file mapping by a private copy of the data
+    void unmap();
+
     // Resizes an existing buffer
     void resize(isize elements);
     void resize(isize elements, T pad);
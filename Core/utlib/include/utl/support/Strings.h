@@ -49,6 +49,9 @@ string uppercased(const string& s);
 // Replaces all unprintable characters
 string makePrintable(const string& s);
 
+// Escapes a string for being used inside a JSON string literal
+string jsonEscaped(const string& s);
+
 
 //
 // Stripping
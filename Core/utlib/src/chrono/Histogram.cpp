@@ -0,0 +1,79 @@
+// -----------------------------------------------------------------------------
+// This file is part of utlib - A lightweight utility library
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the Mozilla Public License v2
+//
+// See https://mozilla.org/MPL/2.0 for license information
+// -----------------------------------------------------------------------------
+
+#include "utl/chrono/Histogram.h"
+#include <algorithm>
+#include <limits>
+
+namespace utl {
+
+void
+Histogram::record(Time value)
+{
+    auto ns = std::max(value.asNanoseconds(), i64(0));
+
+    // Find the first bucket whose (inclusive) upper bound covers the value
+    isize nr = 0;
+    while (nr < isize(bounds.size()) && ns > bounds[nr] * 1000) nr++;
+
+    buckets[nr].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(ns, std::memory_order_relaxed);
+
+    auto max = maximum.load(std::memory_order_relaxed);
+    while (ns > max && !maximum.compare_exchange_weak(max, ns, std::memory_order_relaxed)) { }
+}
+
+void
+Histogram::clear()
+{
+    for (auto &b : buckets) b = 0;
+    total = 0;
+    sum = 0;
+    maximum = 0;
+}
+
+double
+Histogram::bound(isize nr)
+{
+    if (nr < isize(bounds.size())) return double(bounds[nr]) / 1000000.0;
+    return std::numeric_limits<double>::infinity();
+}
+
+Time
+Histogram::quantile(double q) const
+{
+    auto n = count();
+    if (n == 0) return Time(0);
+
+    auto rank = q * double(n);
+    auto max = getMax().asNanoseconds();
+    i64 seen = 0;
+
+    for (isize i = 0; i < numBuckets; i++) {
+
+        auto cnt = bucket(i);
+
+        if (cnt > 0 && double(seen + cnt) >= rank) {
+
+            // Interpolate linearly between the bucket boundaries
+            auto lower = i == 0 ? i64(0) : bounds[i - 1] * 1000;
+            auto upper = i < isize(bounds.size()) ? bounds[i] * 1000 : max;
+            auto frac = (rank - double(seen)) / double(cnt);
+            auto result = lower + i64(frac * double(upper - lower));
+
+            return Time(std::min(result, max));
+        }
+        seen += cnt;
+    }
+
+    return Time(max);
+}
+
+}
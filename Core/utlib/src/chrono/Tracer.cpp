@@ -0,0 +1,243 @@
+// -----------------------------------------------------------------------------
+// This file is part of utlib - A lightweight utility library
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the Mozilla Public License v2
+//
+// See https://mozilla.org/MPL/2.0 for license information
+// -----------------------------------------------------------------------------
+
+#include "utl/chrono/Tracer.h"
+#include "utl/io/IOError.h"
+#include "utl/support/Strings.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+
+namespace utl {
+
+namespace {
+
+// A ring buffer entry. The owning thread may overwrite the entry while it is
+// being exported. The sequence lock lets the reader detect this case.
+struct Slot {
+
+    // Sequence lock (odd while the slot is being written)
+    std::atomic<i64> seq = 0;
+
+    // The recorded span
+    std::atomic<const char *> category = nullptr;
+    std::atomic<const char *> name = nullptr;
+    std::atomic<i64> begin = 0;
+    std::atomic<i64> end = 0;
+};
+
+// The ring buffer of a single thread (only written by the owning thread)
+struct ThreadBuffer {
+
+    isize tid = 0;
+    string name;
+    std::unique_ptr<Slot[]> events;
+    std::atomic<i64> head = 0;
+
+    // Position of the first span recorded since the tracer has been started
+    std::atomic<i64> base = 0;
+
+    // Indicates that the owning thread has terminated
+    bool retired = false;
+
+    // Number of valid spans
+    i64 size() const { return std::min(head.load() - base.load(), i64(Tracer::capacity)); }
+};
+
+// All buffers of running threads and of terminated threads whose spans are
+// part of the current recording
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> registry;
+isize nextTid = 1;
+
+// Frees all buffers of terminated threads (registry must be locked)
+void
+reclaim(bool all)
+{
+    std::erase_if(registry, [&](auto &buffer) {
+        return buffer->retired && (all || buffer->size() == 0);
+    });
+}
+
+// Retires the buffer of a thread when the thread terminates
+struct LocalBuffer {
+
+    ThreadBuffer *buffer = nullptr;
+
+    ~LocalBuffer() {
+
+        if (!buffer) return;
+
+        std::lock_guard<std::mutex> guard(registryMutex);
+        buffer->retired = true;
+        reclaim(false);
+    }
+};
+
+thread_local LocalBuffer local;
+
+ThreadBuffer &
+localBuffer()
+{
+    if (!local.buffer) {
+
+        std::lock_guard<std::mutex> guard(registryMutex);
+
+        registry.push_back(std::make_unique<ThreadBuffer>());
+        local.buffer = registry.back().get();
+        local.buffer->tid = nextTid++;
+        local.buffer->name = "Thread " + std::to_string(local.buffer->tid);
+    }
+    return *local.buffer;
+}
+
+}
+
+std::atomic<bool> Tracer::enabled = false;
+std::atomic<i64> Tracer::origin = 0;
+
+void
+Tracer::start()
+{
+    {   std::lock_guard<std::mutex> guard(registryMutex);
+
+        // Discard the spans of the previous recording
+        reclaim(true);
+        for (auto &buffer : registry) buffer->base = buffer->head.load();
+    }
+
+    origin = Time::now().asNanoseconds();
+    enabled = true;
+}
+
+void
+Tracer::stop()
+{
+    enabled = false;
+}
+
+void
+Tracer::setThreadName(const string &name)
+{
+    auto &buffer = localBuffer();
+
+    std::lock_guard<std::mutex> guard(registryMutex);
+    buffer.name = name;
+}
+
+void
+Tracer::record(const char *category, const char *name, Time begin, Time end)
+{
+    auto &buffer = localBuffer();
+
+    // Allocate the ring buffer when the first span is recorded
+    if (!buffer.events) {
+
+        std::lock_guard<std::mutex> guard(registryMutex);
+        buffer.events = std::make_unique<Slot[]>(capacity);
+    }
+
+    // The n-th span is valid iff the sequence number of its slot equals 2n + 2
+    auto head = buffer.head.load(std::memory_order_relaxed);
+    auto &slot = buffer.events[head % capacity];
+
+    slot.seq.store(2 * head + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.category.store(category, std::memory_order_relaxed);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.begin.store(begin.asNanoseconds(), std::memory_order_relaxed);
+    slot.end.store(end.asNanoseconds(), std::memory_order_relaxed);
+    slot.seq.store(2 * head + 2, std::memory_order_release);
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+isize
+Tracer::count()
+{
+    std::lock_guard<std::mutex> guard(registryMutex);
+
+    isize result = 0;
+    for (auto &buffer : registry) result += isize(buffer->size());
+    return result;
+}
+
+void
+Tracer::save(std::ostream &os)
+{
+    std::lock_guard<std::mutex> guard(registryMutex);
+
+    auto start = origin.load();
+    bool first = true;
+
+    auto separate = [&]() { if (!first) os << ",\n"; first = false; };
+
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    os << std::fixed << std::setprecision(3);
+
+    for (auto &buffer : registry) {
+
+        // Name the thread
+        separate();
+        os << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid;
+        os << ",\"name\":\"thread_name\",\"args\":{\"name\":\"";
+        os << jsonEscaped(buffer->name);
+        os << "\"}}";
+
+        if (!buffer->events) continue;
+
+        auto head = buffer->head.load(std::memory_order_acquire);
+        auto tail = std::max(head - i64(capacity), buffer->base.load());
+
+        for (i64 i = tail; i < head; i++) {
+
+            // Copy the span (the owning thread may continue to write)
+            auto &slot = buffer->events[i % capacity];
+            auto seq = slot.seq.load(std::memory_order_acquire);
+            if (seq != 2 * i + 2) continue;
+
+            Event e = {
+
+                slot.category.load(std::memory_order_relaxed),
+                slot.name.load(std::memory_order_relaxed),
+                slot.begin.load(std::memory_order_relaxed),
+                slot.end.load(std::memory_order_relaxed)
+            };
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            // Discard the span if it has been overwritten while copying
+            if (slot.seq.load(std::memory_order_relaxed) != seq) continue;
+            if (e.begin < start) continue;
+
+            separate();
+            os << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid;
+            os << ",\"cat\":\"";
+            os << jsonEscaped(e.category);
+            os << "\",\"name\":\"";
+            os << jsonEscaped(e.name);
+            os << "\",\"ts\":" << double(e.begin - start) / 1000.0;
+            os << ",\"dur\":" << double(e.end - e.begin) / 1000.0 << "}";
+        }
+    }
+
+    os << "\n]}\n";
+}
+
+void
+Tracer::save(const fs::path &path)
+{
+    std::ofstream stream(path);
+
+    if (!stream.is_open())
+        throw IOError(IOError::FILE_CANT_WRITE, path);
+
+    save(stream);
+}
+
+}
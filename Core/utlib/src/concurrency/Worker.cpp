@@ -0,0 +1,84 @@
+// -----------------------------------------------------------------------------
+// This file is part of utlib - A lightweight utility library
+//
+// Copyright (C) Dirk W. Hoffmann. www.dirkwhoffmann.de
+// Licensed under the Mozilla Public License v2
+//
+// See https://mozilla.org/MPL/2.0 for license information
+// -----------------------------------------------------------------------------
+
+#include "utl/concurrency/Worker.h"
+#include "utl/chrono/Tracer.h"
+#include <cassert>
+#include <utility>
+
+namespace utl {
+
+Worker::Worker(const string &name)
+{
+    thread = std::thread(&Worker::main, this, name);
+}
+
+Worker::~Worker()
+{
+    {   std::lock_guard<std::mutex> guard(mutex);
+        stopping = true;
+    }
+    cond.notify_all();
+    thread.join();
+}
+
+void
+Worker::submit(std::function<void()> job)
+{
+    {   std::lock_guard<std::mutex> guard(mutex);
+
+        assert(!busy);
+        this->job = std::move(job);
+        error = nullptr;
+        busy = true;
+    }
+    cond.notify_all();
+}
+
+void
+Worker::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    cond.wait(lock, [this]() { return !busy; });
+
+    if (error) std::rethrow_exception(std::exchange(error, nullptr));
+}
+
+bool
+Worker::isBusy()
+{
+    std::lock_guard<std::mutex> guard(mutex);
+    return busy;
+}
+
+void
+Worker::main(const string &name)
+{
+    Tracer::setThreadName(name);
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+
+        cond.wait(lock, [this]() { return busy || stopping; });
+        if (stopping) break;
+
+        // Execute the job without holding the lock
+        lock.unlock();
+        std::exception_ptr exception;
+        try { job(); } catch (...) { exception = std::current_exception(); }
+        lock.lock();
+
+        error = exception;
+        busy = false;
+        cond.notify_all();
+    }
+}
+
+}
@@ -15,6 +15,14 @@
 #include <fstream>
 #include <sstream>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define UTL_MMAP
+#endif
+
 namespace utl {
 
 template <class T> void
@@ -59,13 +67,73 @@ Buffer<T>::dealloc()
 
     if (ptr) {
 
+#ifdef UTL_MMAP
+        if (mapped) { munmap((void *)ptr, size * sizeof(T)); } else { delete [] ptr; }
+#else
         delete [] ptr;
+#endif
         ptr = nullptr;
         if (managed) *managed = nullptr;
         size = 0;
+        mapped = false;
     }
 }
 
+template <class T> bool
+Buffer<T>::map(const fs::path &path)
+{
+#ifdef UTL_MMAP
+
+    auto fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    // Only map regular, non-empty files that fit into the buffer
+    struct stat st;
+    auto bytes = fstat(fd, &st) == 0 && S_ISREG(st.st_mode) ? isize(st.st_size) : 0;
+    auto elements = isize(bytes / sizeof(T));
+
+    if (!bytes || bytes % sizeof(T) || usize(elements) > maxCapacity) {
+
+        close(fd);
+        return false;
+    }
+
+    // Pages that have not been written to still reflect changes to the file
+    auto *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (p == MAP_FAILED) return false;
+
+    dealloc();
+    ptr = (T *)p;
+    size = elements;
+    mapped = true;
+    if (managed) *managed = ptr;
+
+    return true;
+
+#else
+
+    return false;
+
+#endif
+}
+
+template <class T> void
+Buffer<T>::unmap()
+{
+    if (!mapped) return;
+
+    auto *p = new T[size];
+    std::memcpy(p, ptr, size * sizeof(T));
+
+    auto elements = size;
+    dealloc();
+    ptr = p;
+    size = elements;
+    if (managed) *managed = ptr;
+}
+
 template <class T> void
 Buffer<T>::init(isize elements)
 {
@@ -282,6 +350,8 @@ Buffer<T>::write(const fs::path &path, isize offset, isize len) const
 template Buffer<T>& Buffer<T>::operator=(const Buffer<T>& other); \
 template void Buffer<T>::alloc(isize bytes); \
 template void Buffer<T>::dealloc(); \
+template bool Buffer<T>::map(const fs::path &path); \
+template void Buffer<T>::unmap(); \
 template void Buffer<T>::init(isize bytes); \
 template void Buffer<T>::init(isize bytes, T value); \
 template void Buffer<T>::init(const T *buf, isize len); \
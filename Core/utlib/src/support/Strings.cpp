@@ -88,6 +88,23 @@ makePrintable(const string& s)
     return result;
 }
 
+string
+jsonEscaped(const string& s)
+{
+    string result;
+    for (auto c : s) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if (u8(c) < 0x20) {
+            result += "\\u00" + hexstr<2>(u8(c));
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
 string
 ltrim(const string &s, const string &characters)
 {